@@ -21,24 +21,65 @@
 #include <string>
 
 #include "agg_file.h"
+#include "logging.h"
+
+#if defined( _MSC_VER ) || defined( __MINGW32__ )
+#define FHEROES2_AGG_MMAP_WINDOWS
+#include <windows.h>
+#elif ( defined( __unix__ ) || defined( __APPLE__ ) ) && !defined( __SWITCH__ ) && !defined( FHEROES2_VITA )
+#define FHEROES2_AGG_MMAP_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace fheroes2
 {
-    AGGFile::AGGFile() {}
+    AGGFile::AGGFile()
+        : _mappedData( nullptr )
+        , _mappedSize( 0 )
+    {}
+
+    AGGFile::~AGGFile()
+    {
+        _unmapFile();
+    }
 
     bool AGGFile::isGood() const
     {
-        return !_stream.fail() && _files.size();
+        return ( _mappedData != nullptr || !_stream.fail() ) && _files.size();
     }
 
     bool AGGFile::open( const std::string & fileName )
     {
+        _files.clear();
+        _unmapFile();
+
+        const size_t fileRecordSize = sizeof( uint32_t ) * 3;
+
+        if ( _mapFile( fileName ) ) {
+            if ( _mappedSize < sizeof( uint16_t ) )
+                return false;
+
+            StreamBuf header( _mappedData, _mappedSize );
+            const size_t count = header.getLE16();
+            const size_t nameEntriesSize = _maxFilenameSize * count;
+
+            if ( count * fileRecordSize + nameEntriesSize >= _mappedSize )
+                return false;
+
+            StreamBuf fileEntries( _mappedData + sizeof( uint16_t ), count * fileRecordSize );
+            StreamBuf nameEntries( _mappedData + _mappedSize - nameEntriesSize, nameEntriesSize );
+
+            return _readEntries( fileEntries, nameEntries, count );
+        }
+
         if ( !_stream.open( fileName, "rb" ) )
             return false;
 
         const size_t size = _stream.size();
         const size_t count = _stream.getLE16();
-        const size_t fileRecordSize = sizeof( uint32_t ) * 3;
 
         if ( count * ( fileRecordSize + _maxFilenameSize ) >= size )
             return false;
@@ -48,6 +89,32 @@ namespace fheroes2
         _stream.seek( size - nameEntriesSize );
         StreamBuf nameEntries = _stream.toStreamBuf( nameEntriesSize );
 
+        return _readEntries( fileEntries, nameEntries, count ) && !_stream.fail();
+    }
+
+    AGGChunk AGGFile::read( const std::string & fileName )
+    {
+        auto it = _files.find( fileName );
+        if ( it != _files.end() ) {
+            const auto & fileParams = it->second;
+            if ( fileParams.first > 0 ) {
+                if ( _mappedData != nullptr ) {
+                    if ( static_cast<size_t>( fileParams.second ) + fileParams.first > _mappedSize )
+                        return AGGChunk();
+
+                    return AGGChunk( _mappedData + fileParams.second, fileParams.first );
+                }
+
+                _stream.seek( fileParams.second );
+                return AGGChunk( _stream.getRaw( fileParams.first ) );
+            }
+        }
+
+        return AGGChunk();
+    }
+
+    bool AGGFile::_readEntries( StreamBuf & fileEntries, StreamBuf & nameEntries, const size_t count )
+    {
         for ( size_t i = 0; i < count; ++i ) {
             const std::string & name = nameEntries.toString( _maxFilenameSize );
             fileEntries.getLE32(); // skip CRC (?) part
@@ -59,21 +126,83 @@ namespace fheroes2
             _files.clear();
             return false;
         }
-        return !_stream.fail();
+        return true;
     }
 
-    std::vector<uint8_t> AGGFile::read( const std::string & fileName )
+    bool AGGFile::_mapFile( const std::string & fileName )
     {
-        auto it = _files.find( fileName );
-        if ( it != _files.end() ) {
-            const auto & fileParams = it->second;
-            if ( fileParams.first > 0 ) {
-                _stream.seek( fileParams.second );
-                return _stream.getRaw( fileParams.first );
-            }
+#if defined( FHEROES2_AGG_MMAP_WINDOWS )
+        const HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+        if ( file == INVALID_HANDLE_VALUE )
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart <= 0 ) {
+            CloseHandle( file );
+            return false;
+        }
+
+        // The view keeps references to the file and the mapping so both handles can be closed right away.
+        const HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        CloseHandle( file );
+        if ( mapping == NULL ) {
+            DEBUG_LOG( DBG_ENGINE, DBG_WARN, "cannot map " << fileName << " into memory, file stream is used" );
+            return false;
+        }
+
+        const void * data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+        if ( data == NULL ) {
+            DEBUG_LOG( DBG_ENGINE, DBG_WARN, "cannot map " << fileName << " into memory, file stream is used" );
+            return false;
         }
 
-        return std::vector<uint8_t>();
+        _mappedData = static_cast<const uint8_t *>( data );
+        _mappedSize = static_cast<size_t>( fileSize.QuadPart );
+        return true;
+#elif defined( FHEROES2_AGG_MMAP_POSIX )
+        const int file = ::open( fileName.c_str(), O_RDONLY );
+        if ( file < 0 )
+            return false;
+
+        struct stat fileStat;
+        if ( fstat( file, &fileStat ) != 0 || fileStat.st_size <= 0 ) {
+            ::close( file );
+            return false;
+        }
+
+        const size_t fileSize = static_cast<size_t>( fileStat.st_size );
+
+        // The mapping stays valid after the file descriptor is closed.
+        void * data = mmap( nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0 );
+        ::close( file );
+        if ( data == MAP_FAILED ) {
+            DEBUG_LOG( DBG_ENGINE, DBG_WARN, "cannot map " << fileName << " into memory, file stream is used" );
+            return false;
+        }
+
+        _mappedData = static_cast<const uint8_t *>( data );
+        _mappedSize = fileSize;
+        return true;
+#else
+        (void)fileName;
+        return false;
+#endif
+    }
+
+    void AGGFile::_unmapFile()
+    {
+        if ( _mappedData == nullptr )
+            return;
+
+#if defined( FHEROES2_AGG_MMAP_WINDOWS )
+        UnmapViewOfFile( _mappedData );
+#elif defined( FHEROES2_AGG_MMAP_POSIX )
+        munmap( const_cast<uint8_t *>( _mappedData ), _mappedSize );
+#endif
+
+        _mappedData = nullptr;
+        _mappedSize = 0;
     }
 }
 
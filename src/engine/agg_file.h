@@ -23,26 +23,81 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "serialize.h"
 
 namespace fheroes2
 {
+    // Read-only content of a file stored in AGG archive. For a memory mapped archive it points directly to the mapped memory
+    // which stays valid while the archive is open, otherwise it holds a copy of the file read from the stream.
+    class AGGChunk
+    {
+    public:
+        AGGChunk()
+            : _data( nullptr )
+            , _size( 0 )
+        {}
+
+        AGGChunk( const uint8_t * data, const size_t size )
+            : _data( data )
+            , _size( size )
+        {}
+
+        explicit AGGChunk( std::vector<uint8_t> && buffer )
+            : _buffer( std::move( buffer ) )
+            , _data( nullptr )
+            , _size( _buffer.size() )
+        {}
+
+        const uint8_t * data() const
+        {
+            return _data != nullptr ? _data : _buffer.data();
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+    private:
+        std::vector<uint8_t> _buffer;
+        const uint8_t * _data;
+        size_t _size;
+    };
+
     class AGGFile
     {
     public:
         AGGFile();
+        AGGFile( const AGGFile & ) = delete;
+        ~AGGFile();
+
+        AGGFile & operator=( const AGGFile & ) = delete;
 
         bool isGood() const;
         bool open( const std::string & fileName );
-        std::vector<uint8_t> read( const std::string & fileName );
+        AGGChunk read( const std::string & fileName );
 
     private:
         static const size_t _maxFilenameSize = 15; // 8.3 ASCIIZ file name + 2-bytes padding
 
         StreamFile _stream;
         std::map<std::string, std::pair<uint32_t, uint32_t> > _files;
+
+        // The whole archive mapped into memory. It is null if memory mapping is not supported or failed.
+        const uint8_t * _mappedData;
+        size_t _mappedSize;
+
+        bool _mapFile( const std::string & fileName );
+        void _unmapFile();
+        bool _readEntries( StreamBuf & fileEntries, StreamBuf & nameEntries, const size_t count );
     };
 
     struct ICNHeader
@@ -43,6 +43,7 @@ namespace Music
     bool isPaused( void );
 
     std::vector<u8> Xmi2Mid( const std::vector<u8> & );
+    std::vector<u8> Xmi2Mid( const u8 * data, size_t size );
 }
 
 #endif
@@ -21,10 +21,27 @@
 #include "image.h"
 #include "palette_h2.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define FHEROES2_IMAGE_SSE2
+#include <emmintrin.h>
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define FHEROES2_IMAGE_AVX2
+#include <immintrin.h>
+#endif
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#define FHEROES2_IMAGE_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined( _MSC_VER ) && defined( FHEROES2_IMAGE_SSE2 )
+#include <intrin.h>
+#endif
+
 namespace
 {
     // 0 in shadow part means no shadow, 1 means skip any drawings so to don't waste extra CPU cycles for ( tableId - 2 ) command we just add extra fake tables
@@ -324,49 +341,305 @@ namespace
         return Verify( inX, inY, outX, outY, width, height, in.width(), in.height(), out.width(), out.height() );
     }
 
-    uint8_t GetPALColorId( uint8_t red, uint8_t green, uint8_t blue )
+    // Run length functions return the number of leading bytes equal to 'value', not more than 'size'.
+    // They are used on transform layer rows to find blocks of opaque (0) or skipped (1) pixels which can be processed at once.
+    // The scalar version is the reference one, vectorized versions must return exactly the same result.
+    uint32_t GetRunLengthScalar( const uint8_t * data, uint32_t size, uint8_t value )
+    {
+        const uint8_t * dataX = data;
+        const uint8_t * dataEnd = data + size;
+
+        for ( ; dataX != dataEnd && *dataX == value; ++dataX ) {
+        }
+
+        return static_cast<uint32_t>( dataX - data );
+    }
+
+#if defined( FHEROES2_IMAGE_SSE2 )
+    uint32_t CountTrailingZeros( uint32_t value )
+    {
+#if defined( _MSC_VER )
+        unsigned long position = 0;
+        _BitScanForward( &position, value );
+        return static_cast<uint32_t>( position );
+#else
+        return static_cast<uint32_t>( __builtin_ctz( value ) );
+#endif
+    }
+
+    uint32_t GetRunLengthSSE2( const uint8_t * data, uint32_t size, uint8_t value )
+    {
+        const __m128i pattern = _mm_set1_epi8( static_cast<char>( value ) );
+
+        uint32_t offset = 0;
+        for ( ; offset + 16 <= size; offset += 16 ) {
+            const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + offset ) );
+            const uint32_t mask = static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( block, pattern ) ) );
+            if ( mask != 0xFFFFu ) {
+                return offset + CountTrailingZeros( ~mask );
+            }
+        }
+
+        return offset + GetRunLengthScalar( data + offset, size - offset, value );
+    }
+#endif
+
+#if defined( FHEROES2_IMAGE_AVX2 )
+    __attribute__( ( target( "avx2" ) ) ) uint32_t GetRunLengthAVX2( const uint8_t * data, uint32_t size, uint8_t value )
     {
-        static std::vector<uint8_t> rgbToId;
-        if ( rgbToId.empty() ) {
-            const uint32_t size = 64 * 64 * 64;
-            rgbToId.resize( size );
-
-            uint32_t r = 0;
-            uint32_t g = 0;
-            uint32_t b = 0;
-
-            for ( uint32_t id = 0; id < size; ++id ) {
-                r = ( id % 64 );
-                g = ( id >> 6 ) % 64;
-                b = ( id >> 12 );
-                int32_t minDistance = 3 * 255 * 255;
-                uint32_t bestPos = 0;
-
-                const uint8_t * correctorX = transformTable + 256 * 15;
-
-                for ( uint32_t i = 0; i < 256; ++i, ++correctorX ) {
-                    const uint8_t * palette = kb_pal + *correctorX * 3;
-
-                    const int32_t offsetRed = static_cast<int32_t>( *( palette ) ) - static_cast<int32_t>( r );
-                    ++palette;
-                    const int32_t offsetGreen = static_cast<int32_t>( *( palette ) ) - static_cast<int32_t>( g );
-                    ++palette;
-                    const int32_t offsetBlue = static_cast<int32_t>( *( palette ) ) - static_cast<int32_t>( b );
-                    ++palette;
-                    const int32_t distance = offsetRed * offsetRed + offsetGreen * offsetGreen + offsetBlue * offsetBlue;
-                    if ( minDistance > distance ) {
-                        minDistance = distance;
-                        bestPos = *correctorX;
+        const __m256i pattern = _mm256_set1_epi8( static_cast<char>( value ) );
+
+        uint32_t offset = 0;
+        for ( ; offset + 32 <= size; offset += 32 ) {
+            const __m256i block = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + offset ) );
+            const uint32_t mask = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, pattern ) ) );
+            if ( mask != 0xFFFFFFFFu ) {
+                return offset + CountTrailingZeros( ~mask );
+            }
+        }
+
+        return offset + GetRunLengthSSE2( data + offset, size - offset, value );
+    }
+#endif
+
+#if defined( FHEROES2_IMAGE_NEON )
+    uint32_t GetRunLengthNEON( const uint8_t * data, uint32_t size, uint8_t value )
+    {
+        const uint8x16_t pattern = vdupq_n_u8( value );
+
+        uint32_t offset = 0;
+        for ( ; offset + 16 <= size; offset += 16 ) {
+            const uint8x16_t equal = vceqq_u8( vld1q_u8( data + offset ), pattern );
+            if ( vminvq_u8( equal ) != 0xFF ) {
+                // The mismatch is within this block.
+                return offset + GetRunLengthScalar( data + offset, 16, value );
+            }
+        }
+
+        return offset + GetRunLengthScalar( data + offset, size - offset, value );
+    }
+#endif
+
+    typedef uint32_t ( *RunLengthFunction )( const uint8_t *, uint32_t, uint8_t );
+
+    RunLengthFunction SelectRunLengthFunction()
+    {
+#if defined( FHEROES2_IMAGE_AVX2 )
+        __builtin_cpu_init();
+        if ( __builtin_cpu_supports( "avx2" ) ) {
+            return GetRunLengthAVX2;
+        }
+#endif
+
+#if defined( FHEROES2_IMAGE_SSE2 )
+        return GetRunLengthSSE2;
+#elif defined( FHEROES2_IMAGE_NEON )
+        return GetRunLengthNEON;
+#else
+        return GetRunLengthScalar;
+#endif
+    }
+
+    RunLengthFunction getRunLength = SelectRunLengthFunction();
+
+    int32_t GetAxisMinDistance( int32_t value, int32_t low, int32_t high )
+    {
+        const int32_t offset = value < low ? low - value : ( value > high ? value - high : 0 );
+        return offset * offset;
+    }
+
+    int32_t GetAxisMaxDistance( int32_t value, int32_t low, int32_t high )
+    {
+        const int32_t offsetLow = value - low;
+        const int32_t offsetHigh = value - high;
+        return std::max( offsetLow * offsetLow, offsetHigh * offsetHigh );
+    }
+
+    // Every cell of 64 x 64 x 64 RGB cube gets the closest color from the palette without cycling colors.
+    // A brute force search takes 67 million distance computations so the cube is split into blocks 4 x 4 x 4 and each block
+    // gets a short list of palette colors which might be the closest to any cell of the block. Colors are kept in palette order
+    // so the result is exactly the same as the one of the brute force search: the first color with the smallest distance.
+    std::vector<uint8_t> CreateRGBToIdTable()
+    {
+        const int32_t cubeSize = 64;
+        const int32_t blockSize = 4;
+
+        // Cycling colors are replaced by non-cycling ones so many palette entries repeat.
+        std::vector<uint8_t> candidates;
+        std::vector<uint8_t> isCandidate( 256, 0 );
+
+        const uint8_t * correctorX = transformTable + 256 * 15;
+        for ( uint32_t i = 0; i < 256; ++i, ++correctorX ) {
+            if ( isCandidate[*correctorX] == 0 ) {
+                isCandidate[*correctorX] = 1;
+                candidates.push_back( *correctorX );
+            }
+        }
+
+        std::vector<uint8_t> rgbToId( cubeSize * cubeSize * cubeSize );
+
+        std::vector<uint8_t> blockCandidates;
+        blockCandidates.reserve( candidates.size() );
+
+        for ( int32_t blockB = 0; blockB < cubeSize; blockB += blockSize ) {
+            for ( int32_t blockG = 0; blockG < cubeSize; blockG += blockSize ) {
+                for ( int32_t blockR = 0; blockR < cubeSize; blockR += blockSize ) {
+                    // No cell of the block is further than this distance from its closest color.
+                    int32_t blockMaxDistance = 3 * 255 * 255;
+                    for ( const uint8_t colorId : candidates ) {
+                        const uint8_t * palette = kb_pal + colorId * 3;
+                        const int32_t distance = GetAxisMaxDistance( palette[0], blockR, blockR + blockSize - 1 )
+                                                 + GetAxisMaxDistance( palette[1], blockG, blockG + blockSize - 1 )
+                                                 + GetAxisMaxDistance( palette[2], blockB, blockB + blockSize - 1 );
+                        blockMaxDistance = std::min( blockMaxDistance, distance );
+                    }
+
+                    blockCandidates.clear();
+                    for ( const uint8_t colorId : candidates ) {
+                        const uint8_t * palette = kb_pal + colorId * 3;
+                        const int32_t distance = GetAxisMinDistance( palette[0], blockR, blockR + blockSize - 1 )
+                                                 + GetAxisMinDistance( palette[1], blockG, blockG + blockSize - 1 )
+                                                 + GetAxisMinDistance( palette[2], blockB, blockB + blockSize - 1 );
+                        if ( distance <= blockMaxDistance ) {
+                            blockCandidates.push_back( colorId );
+                        }
                     }
-                }
 
-                rgbToId[id] = static_cast<uint8_t>( bestPos ); // it's safe to cast
+                    for ( int32_t b = blockB; b < blockB + blockSize; ++b ) {
+                        for ( int32_t g = blockG; g < blockG + blockSize; ++g ) {
+                            for ( int32_t r = blockR; r < blockR + blockSize; ++r ) {
+                                int32_t minDistance = 3 * 255 * 255;
+                                uint8_t bestPos = 0;
+
+                                for ( const uint8_t colorId : blockCandidates ) {
+                                    const uint8_t * palette = kb_pal + colorId * 3;
+
+                                    const int32_t offsetRed = static_cast<int32_t>( palette[0] ) - r;
+                                    const int32_t offsetGreen = static_cast<int32_t>( palette[1] ) - g;
+                                    const int32_t offsetBlue = static_cast<int32_t>( palette[2] ) - b;
+                                    const int32_t distance = offsetRed * offsetRed + offsetGreen * offsetGreen + offsetBlue * offsetBlue;
+                                    if ( minDistance > distance ) {
+                                        minDistance = distance;
+                                        bestPos = colorId;
+                                    }
+                                }
+
+                                rgbToId[r + g * cubeSize + b * cubeSize * cubeSize] = bestPos;
+                            }
+                        }
+                    }
+                }
             }
         }
 
+        return rgbToId;
+    }
+
+    uint8_t GetPALColorId( uint8_t red, uint8_t green, uint8_t blue )
+    {
+        static const std::vector<uint8_t> rgbToId = CreateRGBToIdTable();
+
         return rgbToId[red + green * 64 + blue * 64 * 64];
     }
 
+    // Blending of 2 palette colors with a given alpha value always gives the same palette color.
+    // This table keeps results for one alpha value: 256 rows (one per front color) with 256 entries (one per back color).
+    // Rows are filled on first use as most images contain only a small part of the palette.
+    class AlphaBlendTable
+    {
+    public:
+        explicit AlphaBlendTable( uint8_t alphaValue )
+            : _table( 256 * 256 )
+            , _isRowReady( 256, 0 )
+            , _alphaValue( alphaValue )
+            , _lastUsage( 0 )
+        {}
+
+        uint8_t alpha() const
+        {
+            return _alphaValue;
+        }
+
+        uint32_t lastUsage() const
+        {
+            return _lastUsage;
+        }
+
+        void setLastUsage( uint32_t usage )
+        {
+            _lastUsage = usage;
+        }
+
+        const uint8_t * row( uint8_t inValue )
+        {
+            uint8_t * blendRow = _table.data() + inValue * 256;
+
+            if ( _isRowReady[inValue] == 0 ) {
+                const uint32_t behindValue = 255u - _alphaValue;
+                const uint8_t * inPAL = kb_pal + inValue * 3;
+
+                const uint32_t red = static_cast<uint32_t>( *inPAL ) * _alphaValue;
+                const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * _alphaValue;
+                const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * _alphaValue;
+
+                const uint8_t * outPAL = kb_pal;
+                for ( uint32_t outValue = 0; outValue < 256; ++outValue, outPAL += 3 ) {
+                    const uint32_t blendRed = red + static_cast<uint32_t>( *outPAL ) * behindValue;
+                    const uint32_t blendGreen = green + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
+                    const uint32_t blendBlue = blue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
+                    blendRow[outValue]
+                        = GetPALColorId( static_cast<uint8_t>( blendRed / 255 ), static_cast<uint8_t>( blendGreen / 255 ), static_cast<uint8_t>( blendBlue / 255 ) );
+                }
+
+                _isRowReady[inValue] = 1;
+            }
+
+            return blendRow;
+        }
+
+    private:
+        std::vector<uint8_t> _table;
+        std::vector<uint8_t> _isRowReady;
+        uint8_t _alphaValue;
+        uint32_t _lastUsage;
+    };
+
+    // The game uses only a few alpha values at the same time (unit fading, mirror images, hero fading) so a handful of tables is enough.
+    // The least recently used table is replaced when a new alpha value comes.
+    AlphaBlendTable & GetAlphaBlendTable( uint8_t alphaValue )
+    {
+        static std::vector<AlphaBlendTable> tables;
+        static uint32_t usageCounter = 0;
+
+        const size_t maxTableCount = 16;
+
+        ++usageCounter;
+
+        for ( AlphaBlendTable & table : tables ) {
+            if ( table.alpha() == alphaValue ) {
+                table.setLastUsage( usageCounter );
+                return table;
+            }
+        }
+
+        if ( tables.size() < maxTableCount ) {
+            tables.emplace_back( alphaValue );
+            tables.back().setLastUsage( usageCounter );
+            return tables.back();
+        }
+
+        AlphaBlendTable * oldestTable = &tables.front();
+        for ( AlphaBlendTable & table : tables ) {
+            if ( table.lastUsage() < oldestTable->lastUsage() ) {
+                oldestTable = &table;
+            }
+        }
+
+        *oldestTable = AlphaBlendTable( alphaValue );
+        oldestTable->setLastUsage( usageCounter );
+        return *oldestTable;
+    }
+
     void ApplyRawPalette( const fheroes2::Image & in, fheroes2::Image & out, const uint8_t * palette )
     {
         if ( !IsEqual( in, out ) ) {
@@ -386,6 +659,49 @@ namespace
             }
         }
     }
+
+    // Calls runFunction for the visible part of every run of RLE sprite drawn at (outX, outY). The function receives image layer values of the pixels,
+    // their transform value, the offset of the first output pixel, the number of pixels and the step between output pixels (-1 for flipped sprites).
+    template <typename RunFunction>
+    void ForEachVisibleRun( const fheroes2::RLESprite & in, const fheroes2::Image & out, int32_t outX, int32_t outY, bool flip, RunFunction runFunction )
+    {
+        int32_t inX = 0;
+        int32_t inY = 0;
+        int32_t width = in.width();
+        int32_t height = in.height();
+
+        if ( !Verify( inX, inY, outX, outY, width, height, in.width(), in.height(), out.width(), out.height() ) ) {
+            return;
+        }
+
+        // Range of visible columns of the input sprite. A flipped sprite is clipped from its right side first.
+        const int32_t minX = flip ? in.width() - inX - width : inX;
+        const int32_t maxX = minX + width;
+        const int32_t widthOut = out.width();
+        const int32_t step = flip ? -1 : 1;
+
+        for ( int32_t y = 0; y < height; ++y ) {
+            const int32_t row = inY + y;
+            const int32_t offsetOutY = ( outY + y ) * widthOut + outX;
+            const uint8_t * pixels = in.rowPixels( row );
+            const fheroes2::RLESprite::Run * runEnd = in.rowEnd( row );
+
+            for ( const fheroes2::RLESprite::Run * run = in.rowBegin( row ); run != runEnd; pixels += run->length, ++run ) {
+                if ( run->offset >= maxX ) {
+                    break;
+                }
+
+                const int32_t start = std::max( static_cast<int32_t>( run->offset ), minX );
+                const int32_t end = std::min( static_cast<int32_t>( run->offset + run->length ), maxX );
+                if ( start >= end ) {
+                    continue;
+                }
+
+                const int32_t offsetOut = offsetOutY + ( flip ? maxX - 1 - start : start - minX );
+                runFunction( pixels + ( start - run->offset ), run->transform, offsetOut, end - start, step );
+            }
+        }
+    }
 }
 
 namespace fheroes2
@@ -564,6 +880,59 @@ namespace fheroes2
         std::swap( _y, image._y );
     }
 
+    RLESprite::RLESprite()
+        : _width( 0 )
+        , _height( 0 )
+        , _x( 0 )
+        , _y( 0 )
+    {}
+
+    RLESprite::RLESprite( const Sprite & sprite )
+        : _width( sprite.width() )
+        , _height( sprite.height() )
+        , _x( sprite.x() )
+        , _y( sprite.y() )
+    {
+        if ( sprite.empty() ) {
+            return;
+        }
+
+        _rowRuns.reserve( static_cast<size_t>( _height ) + 1 );
+        _rowPixels.reserve( static_cast<size_t>( _height ) );
+
+        const uint8_t * imageY = sprite.image();
+        const uint8_t * transformY = sprite.transform();
+        const uint32_t rowLength = static_cast<uint32_t>( _width );
+
+        for ( int32_t y = 0; y < _height; ++y, imageY += _width, transformY += _width ) {
+            _rowRuns.push_back( static_cast<uint32_t>( _runs.size() ) );
+            _rowPixels.push_back( static_cast<uint32_t>( _pixels.size() ) );
+
+            uint32_t x = 0;
+            while ( x < rowLength ) {
+                const uint8_t transformValue = transformY[x];
+                const uint32_t length = getRunLength( transformY + x, rowLength - x, transformValue );
+
+                if ( transformValue != 1 ) { // skipped pixels are not stored
+                    Run run;
+                    run.offset = static_cast<uint16_t>( x );
+                    run.length = static_cast<uint16_t>( length );
+                    run.transform = transformValue;
+                    _runs.push_back( run );
+
+                    _pixels.insert( _pixels.end(), imageY + x, imageY + x + length );
+                }
+
+                x += length;
+            }
+        }
+
+        _rowRuns.push_back( static_cast<uint32_t>( _runs.size() ) );
+
+        _runs.shrink_to_fit();
+        _pixels.shrink_to_fit();
+    }
+
     ImageRestorer::ImageRestorer( Image & image )
         : _image( image )
         , _x( 0 )
@@ -708,7 +1077,7 @@ namespace fheroes2
         const int32_t widthIn = in.width();
         const int32_t widthOut = out.width();
 
-        const uint8_t behindValue = 255 - alphaValue;
+        AlphaBlendTable & blendTable = GetAlphaBlendTable( alphaValue );
 
         if ( flip ) {
             const int32_t offsetInY = inY * widthIn + widthIn - 1 - inX;
@@ -735,13 +1104,7 @@ namespace fheroes2
                         inValue = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
                     }
 
-                    const uint8_t * inPAL = kb_pal + inValue * 3;
-                    const uint8_t * outPAL = kb_pal + ( *imageOutX ) * 3;
-
-                    const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                    const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                    const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                    *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                    *imageOutX = blendTable.row( inValue )[*imageOutX];
                 }
             }
         }
@@ -753,29 +1116,27 @@ namespace fheroes2
             uint8_t * imageOutY = out.image() + outY * widthOut + outX;
             const uint8_t * imageInYEnd = imageInY + height * widthIn;
 
-            for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                const uint8_t * imageInX = imageInY;
-                const uint8_t * transformInX = transformInY;
-                uint8_t * imageOutX = imageOutY;
-                const uint8_t * imageInXEnd = imageInX + width;
+            const uint32_t rowLength = static_cast<uint32_t>( width );
 
-                for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                    if ( *transformInX == 1 ) { // skip pixel
+            for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
+                uint32_t x = 0;
+                while ( x < rowLength ) {
+                    const uint8_t transformValue = transformInY[x];
+                    if ( transformValue == 1 ) { // skip pixels
+                        x += getRunLength( transformInY + x, rowLength - x, 1 );
                         continue;
                     }
 
-                    uint8_t inValue = *imageInX;
-                    if ( *transformInX > 1 ) {
-                        inValue = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
+                    uint8_t * imageOutX = imageOutY + x;
+
+                    uint8_t inValue = imageInY[x];
+                    if ( transformValue > 1 ) {
+                        inValue = *( transformTable + transformValue * 256 + *imageOutX );
                     }
 
-                    const uint8_t * inPAL = kb_pal + inValue * 3;
-                    const uint8_t * outPAL = kb_pal + ( *imageOutX ) * 3;
+                    ++x;
 
-                    const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                    const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                    const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                    *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                    *imageOutX = blendTable.row( inValue )[*imageOutX];
                 }
             }
         }
@@ -789,6 +1150,30 @@ namespace fheroes2
         AlphaBlit( in, inPos.x, inPos.y, out, outPos.x, outPos.y, size.width, size.height, flip );
     }
 
+    void AlphaBlit( const RLESprite & in, Image & out, int32_t outX, int32_t outY, uint8_t alphaValue, bool flip )
+    {
+        if ( alphaValue == 0 ) { // there is nothing we need to do
+            return;
+        }
+
+        if ( alphaValue == 255 ) {
+            Blit( in, out, outX, outY, flip );
+            return;
+        }
+
+        // Blitting one image onto another can be done only for image layer so we don't consider transform part of the output image
+        AlphaBlendTable & blendTable = GetAlphaBlendTable( alphaValue );
+        uint8_t * imageOut = out.image();
+
+        ForEachVisibleRun( in, out, outX, outY, flip, [&]( const uint8_t * imageIn, uint8_t transformValue, int32_t offsetOut, int32_t length, int32_t step ) {
+            uint8_t * imageOutX = imageOut + offsetOut;
+            for ( int32_t i = 0; i < length; ++i, ++imageIn, imageOutX += step ) {
+                const uint8_t inValue = ( transformValue == 0 ) ? *imageIn : *( transformTable + transformValue * 256 + *imageOutX );
+                *imageOutX = blendTable.row( inValue )[*imageOutX];
+            }
+        } );
+    }
+
     void ApplyPalette( Image & image, const std::vector<uint8_t> & palette )
     {
         ApplyPalette( image, image, palette );
@@ -878,6 +1263,38 @@ namespace fheroes2
         }
     }
 
+    bool SetBlitCodePath( const BlitCodePath path )
+    {
+        switch ( path ) {
+        case BlitCodePath::SCALAR:
+            getRunLength = GetRunLengthScalar;
+            return true;
+#if defined( FHEROES2_IMAGE_SSE2 )
+        case BlitCodePath::SSE2:
+            getRunLength = GetRunLengthSSE2;
+            return true;
+#endif
+#if defined( FHEROES2_IMAGE_AVX2 )
+        case BlitCodePath::AVX2:
+            __builtin_cpu_init();
+            if ( !__builtin_cpu_supports( "avx2" ) ) {
+                return false;
+            }
+            getRunLength = GetRunLengthAVX2;
+            return true;
+#endif
+#if defined( FHEROES2_IMAGE_NEON )
+        case BlitCodePath::NEON:
+            getRunLength = GetRunLengthNEON;
+            return true;
+#endif
+        default:
+            break;
+        }
+
+        return false;
+    }
+
     void Blit( const Image & in, Image & out, bool flip )
     {
         Blit( in, 0, 0, out, 0, 0, in.width(), in.height(), flip );
@@ -965,21 +1382,25 @@ namespace fheroes2
             uint8_t * imageOutY = out.image() + offsetOutY;
             const uint8_t * imageInYEnd = imageInY + height * widthIn;
 
+            const uint32_t rowLength = static_cast<uint32_t>( width );
+
+            // Rows are processed by runs: a run of opaque pixels is copied at once, a run of skipped pixels is jumped over.
             if ( out.singleLayer() ) {
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                        if ( *transformInX > 0 ) { // apply a transformation
-                            if ( *transformInX != 1 ) { // skip pixel
-                                *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                            }
+                    uint32_t x = 0;
+                    while ( x < rowLength ) {
+                        const uint8_t transformValue = transformInY[x];
+                        if ( transformValue == 0 ) { // copy pixels
+                            const uint32_t length = getRunLength( transformInY + x, rowLength - x, 0 );
+                            memcpy( imageOutY + x, imageInY + x, length );
+                            x += length;
                         }
-                        else { // copy a pixel
-                            *imageOutX = *imageInX;
+                        else if ( transformValue == 1 ) { // skip pixels
+                            x += getRunLength( transformInY + x, rowLength - x, 1 );
+                        }
+                        else { // apply a transformation
+                            imageOutY[x] = *( transformTable + transformValue * 256 + imageOutY[x] );
+                            ++x;
                         }
                     }
                 }
@@ -988,23 +1409,27 @@ namespace fheroes2
                 uint8_t * transformOutY = out.transform() + offsetOutY;
 
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut, transformOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    uint8_t * transformOutX = transformOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX, ++transformOutX ) {
-                        if ( *transformInX == 1 ) { // skip pixel
-                            continue;
+                    uint32_t x = 0;
+                    while ( x < rowLength ) {
+                        const uint8_t transformValue = transformInY[x];
+                        if ( transformValue == 0 ) { // copy pixels
+                            const uint32_t length = getRunLength( transformInY + x, rowLength - x, 0 );
+                            memcpy( imageOutY + x, imageInY + x, length );
+                            memset( transformOutY + x, 0, length );
+                            x += length;
                         }
-
-                        if ( *transformInX > 0 && *transformOutX == 0 ) { // apply a transformation
-                            *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
+                        else if ( transformValue == 1 ) { // skip pixels
+                            x += getRunLength( transformInY + x, rowLength - x, 1 );
                         }
-                        else { // copy a pixel
-                            *transformOutX = *transformInX;
-                            *imageOutX = *imageInX;
+                        else {
+                            if ( transformOutY[x] == 0 ) { // apply a transformation
+                                imageOutY[x] = *( transformTable + transformValue * 256 + imageOutY[x] );
+                            }
+                            else { // copy a pixel
+                                transformOutY[x] = transformValue;
+                                imageOutY[x] = imageInY[x];
+                            }
+                            ++x;
                         }
                     }
                 }
@@ -1020,6 +1445,50 @@ namespace fheroes2
         Blit( in, inPos.x, inPos.y, out, outPos.x, outPos.y, size.width, size.height, flip );
     }
 
+    void Blit( const RLESprite & in, Image & out, int32_t outX, int32_t outY, bool flip )
+    {
+        uint8_t * imageOut = out.image();
+        uint8_t * transformOut = out.singleLayer() ? nullptr : out.transform();
+
+        ForEachVisibleRun( in, out, outX, outY, flip, [&]( const uint8_t * imageIn, uint8_t transformValue, int32_t offsetOut, int32_t length, int32_t step ) {
+            uint8_t * imageOutX = imageOut + offsetOut;
+
+            if ( transformValue == 0 ) { // copy pixels
+                if ( step == 1 ) {
+                    memcpy( imageOutX, imageIn, static_cast<size_t>( length ) );
+                }
+                else {
+                    for ( int32_t i = 0; i < length; ++i, ++imageIn, imageOutX += step ) {
+                        *imageOutX = *imageIn;
+                    }
+                }
+
+                if ( transformOut != nullptr ) {
+                    memset( transformOut + offsetOut + ( step == 1 ? 0 : 1 - length ), 0, static_cast<size_t>( length ) );
+                }
+                return;
+            }
+
+            if ( transformOut == nullptr ) { // apply a transformation
+                for ( int32_t i = 0; i < length; ++i, imageOutX += step ) {
+                    *imageOutX = *( transformTable + transformValue * 256 + *imageOutX );
+                }
+                return;
+            }
+
+            uint8_t * transformOutX = transformOut + offsetOut;
+            for ( int32_t i = 0; i < length; ++i, ++imageIn, imageOutX += step, transformOutX += step ) {
+                if ( *transformOutX == 0 ) { // apply a transformation
+                    *imageOutX = *( transformTable + transformValue * 256 + *imageOutX );
+                }
+                else { // copy a pixel
+                    *transformOutX = transformValue;
+                    *imageOutX = *imageIn;
+                }
+            }
+        } );
+    }
+
     void Copy( const Image & in, Image & out )
     {
         out.resize( in.width(), in.height() );
@@ -1754,6 +2223,39 @@ namespace fheroes2
         *( image.transform() + offset ) = value;
     }
 
+    void Shift( Image & image, int32_t x, int32_t y, int32_t width, int32_t height, int32_t offsetX, int32_t offsetY )
+    {
+        if ( !Verify( image, x, y, width, height ) )
+            return;
+
+        if ( std::abs( offsetX ) >= width || std::abs( offsetY ) >= height || ( offsetX == 0 && offsetY == 0 ) )
+            return;
+
+        const int32_t imageWidth = image.width();
+        const int32_t rowLength = width - std::abs( offsetX );
+        const int32_t rowCount = height - std::abs( offsetY );
+
+        const int32_t inX = offsetX < 0 ? x - offsetX : x;
+        const int32_t outX = offsetX < 0 ? x : x + offsetX;
+
+        // Rows must be processed against the direction of the shift to not overwrite the rows which are not moved yet.
+        int32_t inY = offsetY < 0 ? y - offsetY : y + rowCount - 1;
+        int32_t outY = inY + offsetY;
+        const int32_t stepY = offsetY < 0 ? 1 : -1;
+
+        const bool isSingleLayer = image.singleLayer();
+
+        for ( int32_t i = 0; i < rowCount; ++i, inY += stepY, outY += stepY ) {
+            const int32_t offsetIn = inY * imageWidth + inX;
+            const int32_t offsetOut = outY * imageWidth + outX;
+
+            memmove( image.image() + offsetOut, image.image() + offsetIn, static_cast<size_t>( rowLength ) );
+            if ( !isSingleLayer ) {
+                memmove( image.transform() + offsetOut, image.transform() + offsetIn, static_cast<size_t>( rowLength ) );
+            }
+        }
+    }
+
     Image Stretch( const Image & in, int32_t inX, int32_t inY, int32_t widthIn, int32_t heightIn, int32_t widthOut, int32_t heightOut )
     {
         if ( !Validate( in, inX, inY, widthIn, heightIn ) || widthOut <= 0 || heightOut <= 0 ) {
@@ -125,6 +125,80 @@ namespace fheroes2
         int32_t _y;
     };
 
+    // Sprite which keeps only non-transparent pixels as horizontal runs. Transparent pixels take no memory and are skipped during drawing
+    // without any per-pixel checks. It suits big mostly transparent images like monster animation frames.
+    class RLESprite
+    {
+    public:
+        struct Run
+        {
+            uint16_t offset; // position of the first pixel of the run in a row
+            uint16_t length;
+            uint8_t transform; // transform layer value of all pixels of the run, never 1
+        };
+
+        RLESprite();
+        explicit RLESprite( const Sprite & sprite );
+
+        int32_t width() const
+        {
+            return _width;
+        }
+
+        int32_t height() const
+        {
+            return _height;
+        }
+
+        int32_t x() const
+        {
+            return _x;
+        }
+
+        int32_t y() const
+        {
+            return _y;
+        }
+
+        bool empty() const
+        {
+            return _rowRuns.empty();
+        }
+
+        // Runs of a row are stored within [rowBegin, rowEnd) range while image layer values of their pixels go one after another from rowPixels
+        const Run * rowBegin( int32_t row ) const
+        {
+            return _runs.data() + _rowRuns[row];
+        }
+
+        const Run * rowEnd( int32_t row ) const
+        {
+            return _runs.data() + _rowRuns[row + 1];
+        }
+
+        const uint8_t * rowPixels( int32_t row ) const
+        {
+            return _pixels.data() + _rowPixels[row];
+        }
+
+        // Size of the encoded data in bytes
+        size_t dataSize() const
+        {
+            return _runs.size() * sizeof( Run ) + _pixels.size() + ( _rowRuns.size() + _rowPixels.size() ) * sizeof( uint32_t );
+        }
+
+    private:
+        int32_t _width;
+        int32_t _height;
+        int32_t _x;
+        int32_t _y;
+
+        std::vector<Run> _runs;
+        std::vector<uint8_t> _pixels;
+        std::vector<uint32_t> _rowRuns; // index of the first run of every row plus the total number of runs
+        std::vector<uint32_t> _rowPixels; // offset of the first pixel of every row
+    };
+
     // This class is used in situations when we draw a window within another window
     class ImageRestorer
     {
@@ -186,6 +260,8 @@ namespace fheroes2
     // inPos must contain non-negative values
     void AlphaBlit( const Image & in, const Point & inPos, Image & out, const Point & outPos, const Size & size, bool flip = false );
 
+    void AlphaBlit( const RLESprite & in, Image & out, int32_t outX, int32_t outY, uint8_t alphaValue, bool flip = false );
+
     // apply palette only for image layer, it doesn't affect transform part
     void ApplyPalette( Image & image, const std::vector<uint8_t> & palette );
     void ApplyPalette( const Image & in, Image & out, const std::vector<uint8_t> & palette );
@@ -197,6 +273,19 @@ namespace fheroes2
 
     void ApplyTransform( Image & image, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t transformId );
 
+    // Code paths which Blit and AlphaBlit use to find runs of equal transform layer values. By default the fastest one supported
+    // by the build and the CPU is used. Every path must give the same result as SCALAR.
+    enum class BlitCodePath : int
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // Returns false if the code path isn't supported. Switching the path is meant for self-checks only and is not thread-safe.
+    bool SetBlitCodePath( const BlitCodePath path );
+
     // draw one image onto another
     void Blit( const Image & in, Image & out, bool flip = false );
     void Blit( const Image & in, Image & out, int32_t outX, int32_t outY, bool flip = false );
@@ -205,6 +294,8 @@ namespace fheroes2
     // inPos must contain non-negative values
     void Blit( const Image & in, const Point & inPos, Image & out, const Point & outPos, const Size & size, bool flip = false );
 
+    void Blit( const RLESprite & in, Image & out, int32_t outX, int32_t outY, bool flip = false );
+
     void Copy( const Image & in, Image & out );
     void Copy( const Image & in, int32_t inX, int32_t inY, Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height );
 
@@ -250,6 +341,9 @@ namespace fheroes2
     // Please set value not bigger than 13!
     void SetTransformPixel( Image & image, int32_t x, int32_t y, uint8_t value );
 
+    // Move content of the image area by the offset. Pixels moved out of the area are lost, uncovered pixels remain unchanged.
+    void Shift( Image & image, int32_t x, int32_t y, int32_t width, int32_t height, int32_t offsetX, int32_t offsetY );
+
     Image Stretch( const Image & in, int32_t inX, int32_t inY, int32_t widthIn, int32_t heightIn, int32_t widthOut, int32_t heightOut );
 
     void Transpose( const Image & in, Image & out );
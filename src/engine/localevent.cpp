@@ -864,10 +864,10 @@ namespace
             , _posRenderDrawing( nullptr )
         {}
 
-        bool applyCycling( std::vector<uint8_t> & palette )
+        bool applyCycling( std::vector<uint8_t> & palette, fheroes2::Rect & drawnRoi )
         {
             if ( _preRenderDrawing != nullptr )
-                _preRenderDrawing();
+                drawnRoi = _preRenderDrawing();
 
             if ( _timer.getMs() >= 220 ) {
                 _timer.reset();
@@ -891,7 +891,7 @@ namespace
             return _prevDraw.getMs() >= 220;
         }
 
-        void registerDrawing( void ( *preRenderDrawing )(), void ( *postRenderDrawing )() )
+        void registerDrawing( fheroes2::Rect ( *preRenderDrawing )(), void ( *postRenderDrawing )() )
         {
             if ( preRenderDrawing != nullptr )
                 _preRenderDrawing = preRenderDrawing;
@@ -905,15 +905,15 @@ namespace
         fheroes2::Time _prevDraw;
         uint32_t _counter;
 
-        void ( *_preRenderDrawing )();
+        fheroes2::Rect ( *_preRenderDrawing )();
         void ( *_posRenderDrawing )();
     };
 
     ColorCycling colorCycling;
 
-    bool ApplyCycling( std::vector<uint8_t> & palette )
+    bool ApplyCycling( std::vector<uint8_t> & palette, fheroes2::Rect & drawnRoi )
     {
-        return colorCycling.applyCycling( palette );
+        return colorCycling.applyCycling( palette, drawnRoi );
     }
 
     void ResetCycling()
@@ -929,7 +929,7 @@ LocalEvent & LocalEvent::Get( void )
     return le;
 }
 
-void LocalEvent::RegisterCycling( void ( *preRenderDrawing )(), void ( *postRenderDrawing )() ) const
+void LocalEvent::RegisterCycling( fheroes2::Rect ( *preRenderDrawing )(), void ( *postRenderDrawing )() ) const
 {
     colorCycling.registerDrawing( preRenderDrawing, postRenderDrawing );
 
@@ -961,7 +961,8 @@ LocalEvent & LocalEvent::GetClean()
 bool LocalEvent::HandleEvents( bool delay, bool allowExit )
 {
     if ( colorCycling.isRedrawRequired() ) {
-        fheroes2::Display::instance().render();
+        // Only cycling colors are changed so there is no need to render the whole frame.
+        fheroes2::Display::instance().render( fheroes2::Rect() );
     }
 
     SDL_Event event;
@@ -259,7 +259,8 @@ public:
     KeySym KeyValue( void ) const;
     int KeyMod( void ) const;
 
-    void RegisterCycling( void ( *preRenderDrawing )() = nullptr, void ( *postRenderDrawing )() = nullptr ) const;
+    // preRenderDrawing returns the area it has drawn on the display
+    void RegisterCycling( fheroes2::Rect ( *preRenderDrawing )() = nullptr, void ( *postRenderDrawing )() = nullptr ) const;
 
     // These two methods are useful for video playback
     void PauseCycling();
@@ -20,6 +20,11 @@
 
 #pragma once
 
+#include <cassert>
+#include <functional>
+#include <queue>
+#include <vector>
+
 #include "route.h"
 
 // Base representation of the dataset that mirrors the 2D map being traversed
@@ -45,6 +50,93 @@ struct PathfindingNode
     }
 };
 
+// Monotone priority queue for nodes with non-negative integer priorities (bucket queue, Dial's algorithm).
+// Priorities must not be lower than the priority of the last removed node. Nodes within maxPriorityStep of it are kept
+// in a ring of buckets with O(1) push and pop, which covers Dijkstra and A* with a consistent heuristic when edge costs
+// are bounded. Nodes further away are parked in a heap until the ring reaches them.
+class PathfindingQueue
+{
+public:
+    explicit PathfindingQueue( uint32_t maxPriorityStep )
+    {
+        size_t bucketCount = 1;
+        while ( bucketCount <= maxPriorityStep )
+            bucketCount <<= 1;
+
+        _buckets.resize( bucketCount );
+    }
+
+    void clear()
+    {
+        for ( std::vector<int> & bucket : _buckets )
+            bucket.clear();
+
+        _farNodes = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> >();
+        _bucketedCount = 0;
+        _priority = 0;
+        _position = 0;
+    }
+
+    bool empty() const
+    {
+        return _bucketedCount == 0 && _farNodes.empty();
+    }
+
+    // Priority of the last node returned by pop()
+    uint32_t currentPriority() const
+    {
+        return _priority;
+    }
+
+    void push( int node, uint32_t priority )
+    {
+        assert( priority >= _priority );
+
+        if ( priority - _priority < _buckets.size() ) {
+            _buckets[priority & ( _buckets.size() - 1 )].push_back( node );
+            ++_bucketedCount;
+        }
+        else {
+            _farNodes.emplace( priority, node );
+        }
+    }
+
+    // Returns the node with the lowest priority, nodes with equal priority are returned in the order they were added
+    int pop()
+    {
+        assert( !empty() );
+
+        std::vector<int> * bucket = &_buckets[_priority & ( _buckets.size() - 1 )];
+        while ( _position >= bucket->size() ) {
+            bucket->clear();
+            _position = 0;
+
+            // jump straight to the closest far node if nothing is left in the ring
+            _priority = ( _bucketedCount == 0 ) ? _farNodes.top().first : _priority + 1;
+
+            while ( !_farNodes.empty() && _farNodes.top().first - _priority < _buckets.size() ) {
+                _buckets[_farNodes.top().first & ( _buckets.size() - 1 )].push_back( _farNodes.top().second );
+                _farNodes.pop();
+                ++_bucketedCount;
+            }
+
+            bucket = &_buckets[_priority & ( _buckets.size() - 1 )];
+        }
+
+        --_bucketedCount;
+        return ( *bucket )[_position++];
+    }
+
+private:
+    typedef std::pair<uint32_t, int> QueueEntry;
+
+    std::vector<std::vector<int> > _buckets;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > _farNodes;
+    size_t _bucketedCount = 0;
+    uint32_t _priority = 0;
+    size_t _position = 0;
+};
+
 // Template class has to be either PathfindingNode or its derivative
 template <class T>
 class Pathfinder
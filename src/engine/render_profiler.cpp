@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "render_profiler.h"
+
+#include <array>
+#include <fstream>
+
+namespace
+{
+    const size_t frameCount = 512;
+
+    const char * stageNames[fheroes2::RenderProfiler::STAGE_COUNT]
+        = {"map bottom", "map objects", "map top", "map heroes", "map routes", "map fog", "radar", "interface", "battle", "present", "partial present"};
+
+    typedef std::array<double, fheroes2::RenderProfiler::STAGE_COUNT> FrameTime;
+
+    // Ring buffer of frame timings
+    std::array<FrameTime, frameCount> frames;
+    size_t frameId = 0;
+    size_t storedFrames = 0;
+
+    FrameTime currentFrame = {};
+
+    bool isValidStage( const int stage )
+    {
+        return stage >= 0 && stage < fheroes2::RenderProfiler::STAGE_COUNT;
+    }
+}
+
+namespace fheroes2
+{
+    namespace RenderProfiler
+    {
+        const char * GetStageName( const int stage )
+        {
+            return isValidStage( stage ) ? stageNames[stage] : "unknown";
+        }
+
+        void AddTime( const int stage, const double timeMs )
+        {
+            if ( isValidStage( stage ) ) {
+                currentFrame[stage] += timeMs;
+            }
+        }
+
+        void EndFrame()
+        {
+            frames[frameId] = currentFrame;
+            frameId = ( frameId + 1 ) % frameCount;
+            if ( storedFrames < frameCount ) {
+                ++storedFrames;
+            }
+
+            currentFrame.fill( 0 );
+        }
+
+        bool IsFrameDrawn()
+        {
+            for ( int stage = 0; stage < PRESENT; ++stage ) {
+                if ( currentFrame[stage] > 0 ) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        double GetAverageTime( const int stage )
+        {
+            if ( !isValidStage( stage ) || storedFrames == 0 ) {
+                return 0;
+            }
+
+            double total = 0;
+            for ( size_t i = 0; i < storedFrames; ++i ) {
+                total += frames[i][stage];
+            }
+
+            return total / static_cast<double>( storedFrames );
+        }
+
+        bool SaveCSV( const std::string & path )
+        {
+            std::ofstream file( path.c_str() );
+            if ( !file ) {
+                return false;
+            }
+
+            file << "frame";
+            for ( int stage = 0; stage < STAGE_COUNT; ++stage ) {
+                file << ',' << stageNames[stage];
+            }
+            file << '\n';
+
+            // from the oldest frame to the newest one
+            const size_t firstFrameId = ( storedFrames < frameCount ) ? 0 : frameId;
+            for ( size_t i = 0; i < storedFrames; ++i ) {
+                const FrameTime & frame = frames[( firstFrameId + i ) % frameCount];
+
+                file << i;
+                for ( int stage = 0; stage < STAGE_COUNT; ++stage ) {
+                    file << ',' << frame[stage];
+                }
+                file << '\n';
+            }
+
+            return static_cast<bool>( file );
+        }
+
+        ScopedTimer::ScopedTimer( const int stage )
+            : _stage( stage )
+        {}
+
+        ScopedTimer::~ScopedTimer()
+        {
+            AddTime( _stage, _timer.get() * 1000 );
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "timing.h"
+
+// Render profiling is available only in builds with WITH_RENDER_PROFILING definition.
+#ifdef WITH_RENDER_PROFILING
+#define RENDER_PROFILE( stage ) const fheroes2::RenderProfiler::ScopedTimer renderProfilerTimer( fheroes2::RenderProfiler::stage )
+#else
+#define RENDER_PROFILE( stage )
+#endif
+
+namespace fheroes2
+{
+    namespace RenderProfiler
+    {
+        enum Stage : int
+        {
+            MAP_BOTTOM, // ground, bottom layer and objects of the adventure map
+            MAP_OBJECTS, // monsters and boats
+            MAP_TOP,
+            MAP_HEROES,
+            MAP_ROUTES,
+            MAP_FOG,
+            RADAR,
+            INTERFACE, // adventure map interface except radar
+            BATTLE,
+            PRESENT, // conversion of the display image and its output on screen
+            PARTIAL_PRESENT, // the same for renders of small areas without any drawing, like cursor moves or color cycling. They don't end a frame
+            STAGE_COUNT
+        };
+
+        const char * GetStageName( const int stage );
+
+        // Time is accumulated within a frame until EndFrame() is called.
+        void AddTime( const int stage, const double timeMs );
+        void EndFrame();
+
+        // Returns true if time of any drawing stage (all stages before PRESENT) has been added within the current frame.
+        bool IsFrameDrawn();
+
+        // Returns average time in milliseconds over the stored frames.
+        double GetAverageTime( const int stage );
+
+        // Write timings of the stored frames (up to 512 last frames) into a CSV file.
+        bool SaveCSV( const std::string & path );
+
+        class ScopedTimer
+        {
+        public:
+            explicit ScopedTimer( const int stage );
+            ScopedTimer( const ScopedTimer & ) = delete;
+            ~ScopedTimer();
+
+            ScopedTimer & operator=( const ScopedTimer & ) = delete;
+
+        private:
+            const int _stage;
+            Time _timer;
+        };
+    }
+}
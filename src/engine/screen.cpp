@@ -20,6 +20,7 @@
 
 #include "screen.h"
 #include "palette_h2.h"
+#include "render_profiler.h"
 
 #include <SDL_version.h>
 #if SDL_VERSION_ATLEAST( 2, 0, 0 )
@@ -35,6 +36,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <set>
 
 namespace
@@ -131,6 +133,140 @@ namespace
     }
 
     const uint8_t * currentPalette = PALPAlette();
+
+    // Returns the smallest rectangle containing both rectangles. Empty rectangles are ignored.
+    fheroes2::Rect GetBoundingRect( const fheroes2::Rect & first, const fheroes2::Rect & second )
+    {
+        if ( first.width <= 0 || first.height <= 0 )
+            return second;
+
+        if ( second.width <= 0 || second.height <= 0 )
+            return first;
+
+        const int32_t left = std::min( first.x, second.x );
+        const int32_t top = std::min( first.y, second.y );
+        const int32_t right = std::max( first.x + first.width, second.x + second.width );
+        const int32_t bottom = std::max( first.y + first.height, second.y + second.height );
+
+        return fheroes2::Rect( left, top, right - left, bottom - top );
+    }
+
+    // Marks colors which have different values in the new palette. All colors are marked if there was no palette before.
+    void MarkChangedColors( const std::vector<uint32_t> & oldPalette, const std::vector<uint32_t> & newPalette, std::vector<uint8_t> & changedColors )
+    {
+        changedColors.resize( 256u, 0 );
+
+        if ( oldPalette.size() != newPalette.size() ) {
+            std::fill( changedColors.begin(), changedColors.end(), static_cast<uint8_t>( 1 ) );
+            return;
+        }
+
+        for ( size_t i = 0; i < newPalette.size(); ++i ) {
+            if ( oldPalette[i] != newPalette[i] ) {
+                changedColors[i] = 1;
+            }
+        }
+    }
+
+    // Area of the surface which can contain pixels of changed colors: the pixels found by the last palette update and everything copied since then.
+    // Color cycling changes the same colors every time so the next update doesn't need to look outside this area.
+    struct ChangedColorsArea
+    {
+        fheroes2::Rect roi;
+        std::vector<uint8_t> colors; // colors changed by the last palette update
+    };
+
+    // Color cycling changes only a few palette entries so for 32-bit surfaces we convert only pixels of changed colors
+    // instead of the whole frame. Other surfaces must be uploaded fully. Returns the area of updated pixels. The surface must be locked.
+    fheroes2::Rect UpdateChangedColors( const fheroes2::Display & display, SDL_Surface * surface, const std::vector<uint32_t> & palette32Bit,
+                                        const std::vector<uint8_t> & changedColors, ChangedColorsArea & area )
+    {
+        const int32_t width = display.width();
+        const int32_t height = display.height();
+
+        if ( surface->format->BitsPerPixel != 32 ) {
+            return fheroes2::Rect( 0, 0, width, height );
+        }
+
+        fheroes2::Rect scanRoi( 0, 0, width, height );
+        if ( changedColors == area.colors ) {
+            scanRoi = area.roi;
+        }
+        else {
+            area.colors = changedColors;
+        }
+
+        int32_t minX = width;
+        int32_t minY = height;
+        int32_t maxX = -1;
+        int32_t maxY = -1;
+
+        const uint8_t * inY = display.image() + scanRoi.y * width;
+        uint8_t * outY = static_cast<uint8_t *>( surface->pixels ) + scanRoi.y * surface->pitch;
+        const uint8_t * isChanged = changedColors.data();
+        const uint32_t * transform = palette32Bit.data();
+
+        const int32_t scanEndX = scanRoi.x + scanRoi.width;
+        const int32_t scanEndY = scanRoi.y + scanRoi.height;
+
+        for ( int32_t y = scanRoi.y; y < scanEndY; ++y, inY += width, outY += surface->pitch ) {
+            uint32_t * out = reinterpret_cast<uint32_t *>( outY );
+
+            for ( int32_t x = scanRoi.x; x < scanEndX; ++x ) {
+                const uint8_t value = inY[x];
+                if ( isChanged[value] == 0 )
+                    continue;
+
+                out[x] = transform[value];
+
+                minX = std::min( minX, x );
+                maxX = std::max( maxX, x );
+                if ( maxY != y ) {
+                    minY = std::min( minY, y );
+                    maxY = y;
+                }
+            }
+        }
+
+        area.roi = ( maxX < 0 ) ? fheroes2::Rect() : fheroes2::Rect( minX, minY, maxX - minX + 1, maxY - minY + 1 );
+        return area.roi;
+    }
+
+    // Copies (and converts for 32-bit surfaces) only a given area of the display to SDL surface. The surface must be locked.
+    void CopyToSurface( const fheroes2::Display & display, const fheroes2::Rect & roi, SDL_Surface * surface, const std::vector<uint32_t> & palette32Bit )
+    {
+        const int32_t displayWidth = display.width();
+        const uint8_t * inY = display.image() + roi.y * displayWidth + roi.x;
+        const uint8_t * inYEnd = inY + roi.height * displayWidth;
+
+        if ( surface->format->BitsPerPixel == 32 ) {
+            uint8_t * outY = static_cast<uint8_t *>( surface->pixels ) + roi.y * surface->pitch + roi.x * 4;
+            const uint32_t * transform = palette32Bit.data();
+
+            for ( ; inY != inYEnd; inY += displayWidth, outY += surface->pitch ) {
+                uint32_t * out = reinterpret_cast<uint32_t *>( outY );
+                const uint32_t * outEnd = out + roi.width;
+                const uint8_t * in = inY;
+
+                for ( ; out != outEnd; ++out, ++in )
+                    *out = *( transform + *in );
+            }
+        }
+        else if ( surface->format->BitsPerPixel == 8 ) {
+            if ( surface->pixels == display.image() ) // the display draws directly on the surface
+                return;
+
+            if ( displayWidth == surface->pitch && roi.width == displayWidth ) {
+                memcpy( static_cast<uint8_t *>( surface->pixels ) + roi.y * surface->pitch, inY, static_cast<size_t>( roi.width * roi.height ) );
+                return;
+            }
+
+            uint8_t * outY = static_cast<uint8_t *>( surface->pixels ) + roi.y * surface->pitch + roi.x;
+            for ( ; inY != inYEnd; inY += displayWidth, outY += surface->pitch ) {
+                memcpy( outY, inY, static_cast<size_t>( roi.width ) );
+            }
+        }
+    }
 }
 
 namespace
@@ -426,43 +562,30 @@ namespace
                 SDL_FreeSurface( _surface );
                 _surface = NULL;
             }
+
+            _palette32Bit.clear();
+            _changedColors.clear();
+            _changedColorsArea = ChangedColorsArea();
         }
 
-        virtual void render( const fheroes2::Display & display ) override
+        virtual void render( const fheroes2::Display & display, const fheroes2::Rect & roi ) override
         {
             if ( _surface == NULL )
                 return;
 
-            const int32_t width = display.width();
-            const int32_t height = display.height();
+            fheroes2::Rect updatedRoi = roi;
 
             if ( SDL_MUSTLOCK( _surface ) )
                 SDL_LockSurface( _surface );
 
-            if ( _surface->format->BitsPerPixel == 32 ) {
-                uint32_t * out = static_cast<uint32_t *>( _surface->pixels );
-                const uint32_t * outEnd = out + width * height;
-                const uint8_t * in = display.image();
-                const uint32_t * transform = _palette32Bit.data();
-
-                for ( ; out != outEnd; ++out, ++in )
-                    *out = *( transform + *in );
-            }
-            else if ( _surface->format->BitsPerPixel == 8 ) {
-                if ( _surface->pixels != display.image() ) {
-                    if ( display.width() % 4 != 0 ) {
-                        const int32_t screenWidth = ( display.width() / 4 ) * 4 + 4;
-                        for ( int32_t i = 0; i < display.height(); ++i ) {
-                            memcpy( reinterpret_cast<int8_t *>( _surface->pixels ) + screenWidth * i, display.image() + display.width() * i,
-                                    static_cast<size_t>( width ) );
-                        }
-                    }
-                    else {
-                        memcpy( _surface->pixels, display.image(), static_cast<size_t>( width * height ) );
-                    }
-                }
+            if ( !_changedColors.empty() ) {
+                updatedRoi = GetBoundingRect( roi, UpdateChangedColors( display, _surface, _palette32Bit, _changedColors, _changedColorsArea ) );
+                _changedColors.clear();
             }
 
+            CopyToSurface( display, roi, _surface, _palette32Bit );
+            _changedColorsArea.roi = GetBoundingRect( _changedColorsArea.roi, roi );
+
             if ( SDL_MUSTLOCK( _surface ) )
                 SDL_UnlockSurface( _surface );
 
@@ -473,7 +596,13 @@ namespace
                 _renderer = SDL_CreateRenderer( _window, -1, renderFlags() );
             }
             else {
-                SDL_UpdateTexture( _texture, NULL, _surface->pixels, _surface->pitch );
+                if ( updatedRoi.width > 0 && updatedRoi.height > 0 ) {
+                    const SDL_Rect area = {updatedRoi.x, updatedRoi.y, updatedRoi.width, updatedRoi.height};
+                    const uint8_t * pixels
+                        = static_cast<const uint8_t *>( _surface->pixels ) + updatedRoi.y * _surface->pitch + updatedRoi.x * _surface->format->BytesPerPixel;
+                    SDL_UpdateTexture( _texture, &area, pixels, _surface->pitch );
+                }
+
                 if ( SDL_SetRenderTarget( _renderer, NULL ) == 0 ) {
                     if ( SDL_RenderClear( _renderer ) == 0 && SDL_RenderCopy( _renderer, _texture, NULL, NULL ) == 0 ) {
                         SDL_RenderPresent( _renderer );
@@ -564,20 +693,23 @@ namespace
                 return;
 
             if ( _surface->format->BitsPerPixel == 32 ) {
-                _palette32Bit.resize( 256u );
+                std::vector<uint32_t> palette32Bit( 256u );
 
                 if ( _surface->format->Amask > 0 ) {
                     for ( size_t i = 0; i < 256u; ++i ) {
                         const uint8_t * value = currentPalette + colorIds[i] * 3;
-                        _palette32Bit[i] = SDL_MapRGBA( _surface->format, *( value ), *( value + 1 ), *( value + 2 ), 255 );
+                        palette32Bit[i] = SDL_MapRGBA( _surface->format, *( value ), *( value + 1 ), *( value + 2 ), 255 );
                     }
                 }
                 else {
                     for ( size_t i = 0; i < 256u; ++i ) {
                         const uint8_t * value = currentPalette + colorIds[i] * 3;
-                        _palette32Bit[i] = SDL_MapRGB( _surface->format, *( value ), *( value + 1 ), *( value + 2 ) );
+                        palette32Bit[i] = SDL_MapRGB( _surface->format, *( value ), *( value + 1 ), *( value + 2 ) );
                     }
                 }
+
+                MarkChangedColors( _palette32Bit, palette32Bit, _changedColors );
+                _palette32Bit.swap( palette32Bit );
             }
             else if ( _surface->format->BitsPerPixel == 8 ) {
                 _palette8Bit.resize( 256 );
@@ -591,6 +723,9 @@ namespace
                 }
 
                 SDL_SetPaletteColors( _surface->format->palette, _palette8Bit.data(), 0, 256 );
+
+                // all pixels must be uploaded again with the new palette
+                _changedColors.assign( 256u, 1 );
             }
             else {
                 // This is unsupported format. Please implement it.
@@ -610,6 +745,8 @@ namespace
         SDL_Texture * _texture;
 
         std::vector<uint32_t> _palette32Bit;
+        std::vector<uint8_t> _changedColors; // colors changed by palette updates since the last rendering, empty if none
+        ChangedColorsArea _changedColorsArea;
         std::vector<SDL_Color> _palette8Bit;
 
         std::string _previousWindowTitle;
@@ -774,45 +911,33 @@ namespace
             , _bitDepth( 8 )
         {}
 
-        virtual void render( const fheroes2::Display & display ) override
+        virtual void render( const fheroes2::Display & display, const fheroes2::Rect & roi ) override
         {
             if ( _surface == NULL ) // nothing to render on
                 return;
 
-            const int32_t width = display.width();
-            const int32_t height = display.height();
+            fheroes2::Rect updatedRoi = roi;
 
             if ( SDL_MUSTLOCK( _surface ) )
                 SDL_LockSurface( _surface );
 
-            if ( _surface->format->BitsPerPixel == 32 ) {
-                uint32_t * out = static_cast<uint32_t *>( _surface->pixels );
-                const uint32_t * outEnd = out + width * height;
-                const uint8_t * in = display.image();
-                const uint32_t * transform = _palette32Bit.data();
-
-                for ( ; out != outEnd; ++out, ++in )
-                    *out = *( transform + *in );
-            }
-            else if ( _surface->format->BitsPerPixel == 8 ) {
-                if ( _surface->pixels != display.image() ) {
-                    if ( display.width() % 4 != 0 ) {
-                        const int32_t screenWidth = ( display.width() / 4 ) * 4 + 4;
-                        for ( int32_t i = 0; i < display.height(); ++i ) {
-                            memcpy( reinterpret_cast<int8_t *>( _surface->pixels ) + screenWidth * i, display.image() + display.width() * i,
-                                    static_cast<size_t>( width ) );
-                        }
-                    }
-                    else {
-                        memcpy( _surface->pixels, display.image(), static_cast<size_t>( width * height ) );
-                    }
-                }
+            if ( !_changedColors.empty() ) {
+                updatedRoi = GetBoundingRect( roi, UpdateChangedColors( display, _surface, _palette32Bit, _changedColors, _changedColorsArea ) );
+                _changedColors.clear();
             }
 
+            CopyToSurface( display, roi, _surface, _palette32Bit );
+            _changedColorsArea.roi = GetBoundingRect( _changedColorsArea.roi, roi );
+
             if ( SDL_MUSTLOCK( _surface ) )
                 SDL_UnlockSurface( _surface );
 
-            SDL_Flip( _surface );
+            if ( updatedRoi.width == display.width() && updatedRoi.height == display.height() ) {
+                SDL_Flip( _surface );
+            }
+            else if ( updatedRoi.width > 0 && updatedRoi.height > 0 ) {
+                SDL_UpdateRect( _surface, updatedRoi.x, updatedRoi.y, static_cast<uint32_t>( updatedRoi.width ), static_cast<uint32_t>( updatedRoi.height ) );
+            }
         }
 
         virtual void clear() override
@@ -826,6 +951,8 @@ namespace
 
             _palette32Bit.clear();
             _palette8Bit.clear();
+            _changedColors.clear();
+            _changedColorsArea = ChangedColorsArea();
         }
 
         virtual bool allocate( int32_t & width_, int32_t & height_, bool isFullScreen ) override
@@ -864,20 +991,23 @@ namespace
                 return;
 
             if ( _surface->format->BitsPerPixel == 32 ) {
-                _palette32Bit.resize( 256u );
+                std::vector<uint32_t> palette32Bit( 256u );
 
                 if ( _surface->format->Amask > 0 ) {
                     for ( size_t i = 0; i < 256u; ++i ) {
                         const uint8_t * value = currentPalette + colorIds[i] * 3;
-                        _palette32Bit[i] = SDL_MapRGBA( _surface->format, *( value ), *( value + 1 ), *( value + 2 ), 255 );
+                        palette32Bit[i] = SDL_MapRGBA( _surface->format, *( value ), *( value + 1 ), *( value + 2 ), 255 );
                     }
                 }
                 else {
                     for ( size_t i = 0; i < 256u; ++i ) {
                         const uint8_t * value = currentPalette + colorIds[i] * 3;
-                        _palette32Bit[i] = SDL_MapRGB( _surface->format, *( value ), *( value + 1 ), *( value + 2 ) );
+                        palette32Bit[i] = SDL_MapRGB( _surface->format, *( value ), *( value + 1 ), *( value + 2 ) );
                     }
                 }
+
+                MarkChangedColors( _palette32Bit, palette32Bit, _changedColors );
+                _palette32Bit.swap( palette32Bit );
             }
             else if ( _surface->format->BitsPerPixel == 8 ) {
                 _palette8Bit.resize( 256 );
@@ -891,6 +1021,9 @@ namespace
                 }
 
                 SDL_SetPalette( _surface, SDL_LOGPAL | SDL_PHYSPAL, _palette8Bit.data(), 0, 256 );
+
+                // all pixels must be uploaded again with the new palette
+                _changedColors.assign( 256u, 1 );
             }
             else {
                 // This is unsupported format. Please implement it.
@@ -906,6 +1039,8 @@ namespace
     private:
         SDL_Surface * _surface;
         std::vector<uint32_t> _palette32Bit;
+        std::vector<uint8_t> _changedColors; // colors changed by palette updates since the last rendering, empty if none
+        ChangedColorsArea _changedColorsArea;
         std::vector<SDL_Color> _palette8Bit;
         int _bitDepth;
 
@@ -983,6 +1118,9 @@ namespace fheroes2
         }
 
         Image::resize( width_, height_ );
+
+        _prevCursorRoi = Rect();
+        _prevPreprocessingRoi = Rect();
     }
 
     bool Display::isDefaultSize() const
@@ -998,12 +1136,31 @@ namespace fheroes2
 
     void Display::render()
     {
+        render( Rect( 0, 0, width(), height() ) );
+    }
+
+    void Display::render( const Rect & roi )
+    {
+        if ( empty() )
+            return;
+
+        const Rect displayRoi( 0, 0, width(), height() );
+
+        Rect updatedRoi;
+        if ( roi.width > 0 && roi.height > 0 && ( displayRoi & roi ) ) {
+            updatedRoi = displayRoi ^ roi;
+        }
+
         if ( _cursor->isVisible() && _cursor->isSoftwareEmulation() && !_cursor->_image.empty() ) {
             const Sprite & cursorImage = _cursor->_image;
             const Sprite backup = Crop( *this, cursorImage.x(), cursorImage.y(), cursorImage.width(), cursorImage.height() );
             Blit( cursorImage, *this, cursorImage.x(), cursorImage.y() );
 
-            _renderFrame();
+            const Rect cursorRoi = displayRoi ^ Rect( cursorImage.x(), cursorImage.y(), cursorImage.width(), cursorImage.height() );
+            updatedRoi = GetBoundingRect( GetBoundingRect( updatedRoi, cursorRoi ), _prevCursorRoi );
+            _prevCursorRoi = cursorRoi;
+
+            _renderFrame( updatedRoi );
 
             if ( _postprocessing != nullptr ) {
                 _postprocessing();
@@ -1012,7 +1169,10 @@ namespace fheroes2
             Copy( backup, 0, 0, *this, backup.x(), backup.y(), backup.width(), backup.height() );
         }
         else {
-            _renderFrame();
+            updatedRoi = GetBoundingRect( updatedRoi, _prevCursorRoi );
+            _prevCursorRoi = Rect();
+
+            _renderFrame( updatedRoi );
 
             if ( _postprocessing != nullptr ) {
                 _postprocessing();
@@ -1020,21 +1180,53 @@ namespace fheroes2
         }
     }
 
-    void Display::_renderFrame()
+    void Display::_renderFrame( const Rect & roi )
     {
-        bool updateImage = true;
-        if ( _preprocessing != NULL ) {
-            std::vector<uint8_t> palette;
-            if ( _preprocessing( palette ) ) {
-                _engine->updatePalette( palette );
-                // when we change a palette for 8-bit image we unwillingly call render so we don't need to re-render the same frame again
-                updateImage = ( _renderSurface == NULL );
+#ifdef WITH_RENDER_PROFILING
+        // Cursor moves and color cycling render small areas much more often than the game draws frames so their time is reported separately.
+        const bool isGameFrame = ( roi == Rect( 0, 0, width(), height() ) ) || RenderProfiler::IsFrameDrawn();
+#endif
+
+        {
+#ifdef WITH_RENDER_PROFILING
+            const RenderProfiler::ScopedTimer renderProfilerTimer( isGameFrame ? RenderProfiler::PRESENT : RenderProfiler::PARTIAL_PRESENT );
+#endif
+
+            bool updateImage = true;
+
+            // the area drawn by preprocessing last time has been restored since then
+            Rect updatedRoi = GetBoundingRect( roi, _prevPreprocessingRoi );
+            _prevPreprocessingRoi = Rect();
+
+            if ( _preprocessing != NULL ) {
+                std::vector<uint8_t> palette;
+                Rect drawnRoi;
+                const bool isPaletteChanged = _preprocessing( palette, drawnRoi );
+
+                const Rect displayRoi( 0, 0, width(), height() );
+                if ( drawnRoi.width > 0 && drawnRoi.height > 0 && ( displayRoi & drawnRoi ) ) {
+                    _prevPreprocessingRoi = displayRoi ^ drawnRoi;
+                    updatedRoi = GetBoundingRect( updatedRoi, _prevPreprocessingRoi );
+                }
+
+                if ( isPaletteChanged ) {
+                    _engine->updatePalette( palette );
+                    // when we change a palette for 8-bit image we unwillingly call render so we don't need to re-render the same frame again
+                    // The render engine itself updates pixels of changed colors outside the given area.
+                    updateImage = ( _renderSurface == NULL );
+                }
+            }
+
+            if ( updateImage ) {
+                _engine->render( *this, updatedRoi );
             }
         }
 
-        if ( updateImage ) {
-            _engine->render( *this );
+#ifdef WITH_RENDER_PROFILING
+        if ( isGameFrame ) {
+            RenderProfiler::EndFrame();
         }
+#endif
     }
 
     void Display::subscribe( PreRenderProcessing preprocessing, PostRenderProcessing postprocessing )
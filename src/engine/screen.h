@@ -68,7 +68,8 @@ namespace fheroes2
         {}
 
         virtual void clear() {}
-        virtual void render( const Display & ) {}
+        // render only a given area of the display, the area is always within the display
+        virtual void render( const Display &, const Rect & ) {}
         virtual bool allocate( int32_t &, int32_t &, bool )
         {
             return false;
@@ -104,11 +105,16 @@ namespace fheroes2
 
         void render(); // render the image on screen
 
+        // Render only a part of the image on screen. Use it when you know that nothing has been changed outside the area.
+        // The area of the software cursor (current and previous positions), the area drawn by preprocessing (current and previous ones) and pixels
+        // of colors changed by a new palette are always rendered as well so an empty area can be used when only the palette or the cursor have been changed.
+        void render( const Rect & roi );
+
         virtual void resize( int32_t width_, int32_t height_ ) override;
         bool isDefaultSize() const;
 
-        // this function must return true if new palette has been generated
-        typedef bool ( *PreRenderProcessing )( std::vector<uint8_t> & palette );
+        // this function must return true if new palette has been generated. The area of the image drawn by the function must be set to drawnRoi
+        typedef bool ( *PreRenderProcessing )( std::vector<uint8_t> & palette, Rect & drawnRoi );
         typedef void ( *PostRenderProcessing )();
         void subscribe( PreRenderProcessing preprocessing, PostRenderProcessing postprocessing );
 
@@ -135,9 +141,15 @@ namespace fheroes2
 
         uint8_t * _renderSurface;
 
+        // Area of software cursor drawn during previous rendering. It must be restored on screen during the next rendering.
+        Rect _prevCursorRoi;
+
+        // Area drawn by preprocessing during previous rendering. It's restored by postprocessing so it must be rendered again next time.
+        Rect _prevPreprocessingRoi;
+
         Display();
 
-        void _renderFrame(); // prepare and render a frame
+        void _renderFrame( const Rect & roi ); // prepare and render a frame
     };
 
     class Cursor
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+
+#include "thread_pool.h"
+
+namespace fheroes2
+{
+    ThreadPool::ThreadPool( size_t threadCount )
+        : _task( nullptr )
+        , _taskCount( 0 )
+        , _nextTaskId( 0 )
+        , _completedTaskCount( 0 )
+        , _jobId( 0 )
+        , _exitFlag( false )
+    {
+        for ( size_t i = 0; i < threadCount; ++i ) {
+            // worker 0 is the thread calling runTasks()
+            _workers.emplace_back( new std::thread( ThreadPool::_workerThread, this, i + 1 ) );
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        _mutex.lock();
+        _exitFlag = true;
+        _workerNotification.notify_all();
+        _mutex.unlock();
+
+        for ( std::unique_ptr<std::thread> & worker : _workers ) {
+            worker->join();
+        }
+    }
+
+    void ThreadPool::runTasks( size_t taskCount, const std::function<void( size_t, size_t )> & task )
+    {
+        if ( taskCount == 0 )
+            return;
+
+        if ( _workers.empty() || taskCount == 1 ) {
+            for ( size_t taskId = 0; taskId < taskCount; ++taskId ) {
+                task( taskId, 0 );
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> mutexLock( _mutex );
+
+        assert( _task == nullptr );
+
+        _task = &task;
+        _taskCount = taskCount;
+        _nextTaskId = 0;
+        _completedTaskCount = 0;
+        ++_jobId;
+        _workerNotification.notify_all();
+
+        _executeTasks( 0, mutexLock );
+
+        _masterNotification.wait( mutexLock, [this] { return _completedTaskCount == _taskCount; } );
+
+        _task = nullptr;
+    }
+
+    ThreadPool & ThreadPool::Get()
+    {
+        static ThreadPool pool( std::max( std::thread::hardware_concurrency(), 1u ) - 1 );
+        return pool;
+    }
+
+    void ThreadPool::_executeTasks( size_t workerId, std::unique_lock<std::mutex> & mutexLock )
+    {
+        while ( _task != nullptr && _nextTaskId < _taskCount ) {
+            const size_t taskId = _nextTaskId++;
+            const std::function<void( size_t, size_t )> & task = *_task;
+
+            mutexLock.unlock();
+            task( taskId, workerId );
+            mutexLock.lock();
+
+            ++_completedTaskCount;
+            if ( _completedTaskCount == _taskCount )
+                _masterNotification.notify_one();
+        }
+    }
+
+    void ThreadPool::_workerThread( ThreadPool * pool, size_t workerId )
+    {
+        assert( pool != nullptr );
+
+        uint32_t lastJobId = 0;
+
+        std::unique_lock<std::mutex> mutexLock( pool->_mutex );
+        while ( true ) {
+            pool->_workerNotification.wait( mutexLock, [&] { return pool->_exitFlag || pool->_jobId != lastJobId; } );
+
+            if ( pool->_exitFlag )
+                break;
+
+            lastJobId = pool->_jobId;
+            pool->_executeTasks( workerId, mutexLock );
+        }
+    }
+}
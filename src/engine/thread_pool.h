@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fheroes2
+{
+    // Fixed set of worker threads for independent CPU-bound tasks.
+    class ThreadPool
+    {
+    public:
+        // Zero threads means that all tasks are executed by the calling thread.
+        explicit ThreadPool( size_t threadCount );
+        ~ThreadPool();
+
+        ThreadPool( const ThreadPool & ) = delete;
+        ThreadPool & operator=( const ThreadPool & ) = delete;
+
+        // Number of threads executing tasks including the calling one; workerId passed to tasks is less than this value.
+        size_t workerCount() const
+        {
+            return _workers.size() + 1;
+        }
+
+        // Executes task( taskId, workerId ) for every taskId in [0, taskCount) and returns when all of them are done.
+        // Tasks must not call runTasks() themselves.
+        void runTasks( size_t taskCount, const std::function<void( size_t, size_t )> & task );
+
+        // Shared pool with one thread less than the number of hardware threads.
+        static ThreadPool & Get();
+
+    private:
+        std::vector<std::unique_ptr<std::thread> > _workers;
+        std::mutex _mutex;
+        std::condition_variable _workerNotification;
+        std::condition_variable _masterNotification;
+
+        const std::function<void( size_t, size_t )> * _task;
+        size_t _taskCount;
+        size_t _nextTaskId;
+        size_t _completedTaskCount;
+        uint32_t _jobId;
+        bool _exitFlag;
+
+        void _executeTasks( size_t workerId, std::unique_lock<std::mutex> & mutexLock );
+
+        static void _workerThread( ThreadPool * pool, size_t workerId );
+    };
+}
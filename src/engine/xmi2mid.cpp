@@ -180,9 +180,9 @@ struct XMIData
 {
     XMITracks tracks;
 
-    XMIData( const std::vector<u8> & buf )
+    XMIData( const u8 * data, size_t size )
     {
-        StreamBuf sb( buf );
+        StreamBuf sb( data, size );
 
         GroupChunkHeader group;
         IFFChunkHeader iff;
@@ -528,7 +528,12 @@ StreamBuf & operator<<( StreamBuf & sb, const MidData & st )
 
 std::vector<u8> Music::Xmi2Mid( const std::vector<u8> & buf )
 {
-    XMIData xmi( buf );
+    return Xmi2Mid( buf.data(), buf.size() );
+}
+
+std::vector<u8> Music::Xmi2Mid( const u8 * data, size_t size )
+{
+    XMIData xmi( data, size );
     StreamBuf sb( 16 * 4096 );
 
     if ( xmi.isvalid() ) {
@@ -21,13 +21,18 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include "agg.h"
@@ -84,8 +89,21 @@ namespace AGG
     fheroes2::AGGFile heroes2_agg;
     fheroes2::AGGFile heroes2x_agg;
 
+    // ICN and TIL data is read by the main thread and the resource prefetcher simultaneously.
+    std::mutex g_dataFileMutex;
+
     std::map<int, std::vector<u8> > wav_cache;
     std::map<int, std::vector<u8> > mid_cache;
+
+    // Period of the last use of every cached sound and the total size of sound caches in bytes
+    std::map<int, uint32_t> wav_cache_last_used;
+    std::map<int, uint32_t> mid_cache_last_used;
+    size_t wav_cache_size = 0;
+    size_t mid_cache_size = 0;
+
+    // Resources used within the current period are considered as displayed or played and they are never released.
+    // A new period starts on every ReleaseUnusedResources call.
+    std::atomic<uint32_t> resource_use_period( 1 );
     std::vector<loop_sound_t> loop_sounds;
     // std::map<u32, fnt_cache_t> fnt_cache;
 
@@ -104,8 +122,8 @@ namespace AGG
     void LoadFNT( void );
 
     bool ReadDataDir( void );
-    std::vector<uint8_t> ReadChunk( const std::string & key, bool ignoreExpansion = false );
-    std::vector<uint8_t> ReadMusicChunk( const std::string & key, const bool ignoreExpansion = false );
+    fheroes2::AGGChunk ReadChunk( const std::string & key, bool ignoreExpansion = false );
+    fheroes2::AGGChunk ReadMusicChunk( const std::string & key, const bool ignoreExpansion = false );
 
     void PlayMusicInternally( const int mus, const bool loop );
     void PlaySoundInternally( const int m82 );
@@ -344,23 +362,25 @@ bool AGG::ReadDataDir( void )
     return heroes2_agg.isGood();
 }
 
-std::vector<uint8_t> AGG::ReadChunk( const std::string & key, bool ignoreExpansion )
+fheroes2::AGGChunk AGG::ReadChunk( const std::string & key, bool ignoreExpansion )
 {
+    std::lock_guard<std::mutex> mutexLock( g_dataFileMutex );
+
     if ( !ignoreExpansion && heroes2x_agg.isGood() ) {
-        const std::vector<u8> & buf = heroes2x_agg.read( key );
-        if ( buf.size() )
-            return buf;
+        fheroes2::AGGChunk chunk = heroes2x_agg.read( key );
+        if ( !chunk.empty() )
+            return chunk;
     }
 
     return heroes2_agg.read( key );
 }
 
-std::vector<uint8_t> AGG::ReadMusicChunk( const std::string & key, const bool ignoreExpansion )
+fheroes2::AGGChunk AGG::ReadMusicChunk( const std::string & key, const bool ignoreExpansion )
 {
     if ( !ignoreExpansion && g_midiHeroes2xAGG.isGood() ) {
-        const std::vector<uint8_t> & buf = g_midiHeroes2xAGG.read( key );
-        if ( !buf.empty() )
-            return buf;
+        fheroes2::AGGChunk chunk = g_midiHeroes2xAGG.read( key );
+        if ( !chunk.empty() )
+            return chunk;
     }
 
     return g_midiHeroes2AGG.read( key );
@@ -397,9 +417,9 @@ void AGG::LoadWAV( int m82, std::vector<u8> & v )
 #endif
 
     DEBUG_LOG( DBG_ENGINE, DBG_TRACE, M82::GetString( m82 ) );
-    const std::vector<u8> & body = ReadMusicChunk( M82::GetString( m82 ) );
+    const fheroes2::AGGChunk body = ReadMusicChunk( M82::GetString( m82 ) );
 
-    if ( body.size() ) {
+    if ( !body.empty() ) {
 #ifdef WITH_MIXER
         // create WAV format
         StreamBuf wavHeader( 44 );
@@ -419,7 +439,7 @@ void AGG::LoadWAV( int m82, std::vector<u8> & v )
 
         v.reserve( body.size() + 44 );
         v.assign( wavHeader.data(), wavHeader.data() + 44 );
-        v.insert( v.begin() + 44, body.begin(), body.end() );
+        v.insert( v.begin() + 44, body.data(), body.data() + body.size() );
 #else
         Audio::Spec wav_spec;
         wav_spec.format = AUDIO_U8;
@@ -436,7 +456,7 @@ void AGG::LoadWAV( int m82, std::vector<u8> & v )
             cvt.buf = new u8[size];
             cvt.len = body.size();
 
-            memcpy( cvt.buf, &body[0], body.size() );
+            memcpy( cvt.buf, body.data(), body.size() );
 
             cvt.Convert();
 
@@ -453,10 +473,10 @@ void AGG::LoadWAV( int m82, std::vector<u8> & v )
 void AGG::LoadMID( int xmi, std::vector<u8> & v )
 {
     DEBUG_LOG( DBG_ENGINE, DBG_TRACE, XMI::GetString( xmi ) );
-    const std::vector<uint8_t> & body = ReadMusicChunk( XMI::GetString( xmi ), xmi >= XMI::MIDI_ORIGINAL_KNIGHT );
+    const fheroes2::AGGChunk body = ReadMusicChunk( XMI::GetString( xmi ), xmi >= XMI::MIDI_ORIGINAL_KNIGHT );
 
     if ( !body.empty() ) {
-        v = Music::Xmi2Mid( body );
+        v = Music::Xmi2Mid( body.data(), body.size() );
     }
 }
 
@@ -464,8 +484,11 @@ void AGG::LoadMID( int xmi, std::vector<u8> & v )
 const std::vector<u8> & AGG::GetWAV( int m82 )
 {
     std::vector<u8> & v = wav_cache[m82];
-    if ( Mixer::isValid() && v.empty() )
+    if ( Mixer::isValid() && v.empty() ) {
         LoadWAV( m82, v );
+        wav_cache_size += v.size();
+    }
+    wav_cache_last_used[m82] = resource_use_period;
     return v;
 }
 
@@ -473,8 +496,11 @@ const std::vector<u8> & AGG::GetWAV( int m82 )
 const std::vector<u8> & AGG::GetMID( int xmi )
 {
     std::vector<u8> & v = mid_cache[xmi];
-    if ( Mixer::isValid() && v.empty() )
+    if ( Mixer::isValid() && v.empty() ) {
         LoadMID( xmi, v );
+        mid_cache_size += v.size();
+    }
+    mid_cache_last_used[xmi] = resource_use_period;
     return v;
 }
 
@@ -748,7 +774,8 @@ void AGG::LoadFNT( void )
 std::vector<u8> AGG::LoadBINFRM( const char * frm_file )
 {
     DEBUG_LOG( DBG_ENGINE, DBG_TRACE, frm_file );
-    return AGG::ReadChunk( frm_file );
+    const fheroes2::AGGChunk chunk = AGG::ReadChunk( frm_file );
+    return std::vector<u8>( chunk.data(), chunk.data() + chunk.size() );
 }
 
 void AGG::ResetMixer()
@@ -808,6 +835,10 @@ void AGG::Quit( void )
 {
     wav_cache.clear();
     mid_cache.clear();
+    wav_cache_last_used.clear();
+    mid_cache_last_used.clear();
+    wav_cache_size = 0;
+    mid_cache_size = 0;
     loop_sounds.clear();
     // fnt_cache.clear();
 
@@ -824,10 +855,31 @@ namespace fheroes2
         std::vector<std::vector<std::vector<fheroes2::Image> > > _tilVsImage( TIL::LASTTIL );
         const fheroes2::Sprite errorImage;
 
+        std::vector<std::vector<fheroes2::RLESprite> > _icnVsRLESprite( ICN::LASTICN );
+        const fheroes2::RLESprite errorRLEImage;
+
         const uint32_t headerSize = 6;
 
         std::map<int, std::vector<fheroes2::Sprite> > _icnVsScaledSprite;
 
+        struct PaletteSprite
+        {
+            Sprite sprite;
+            uint64_t lastUsed = 0;
+        };
+
+        // ICN sprites with applied palette and flip. The key is ICN ID, sprite index, palette type and flip flag.
+        std::map<std::tuple<int, uint32_t, int, bool>, PaletteSprite> _icnVsPaletteSprite;
+        size_t _paletteSpriteCacheSize = 0; // in bytes
+        const size_t paletteSpriteCacheLimit = 16 * 1024 * 1024; // in bytes
+        uint64_t _paletteSpriteCacheHits = 0;
+        uint64_t _paletteSpriteCacheMisses = 0;
+
+        size_t GetImageSize( const Image & image )
+        {
+            return static_cast<size_t>( image.width() ) * static_cast<size_t>( image.height() ) * ( image.singleLayer() ? 1 : 2 );
+        }
+
         bool IsValidICNId( int id )
         {
             return id >= 0 && static_cast<size_t>( id ) < _icnVsSprite.size();
@@ -838,23 +890,85 @@ namespace fheroes2
             return id >= 0 && static_cast<size_t>( id ) < _tilVsImage.size();
         }
 
-        void LoadOriginalICN( int id )
+        // Period of the last use and size in bytes of every ICN and TIL, see ::AGG::ReleaseUnusedResources
+        std::vector<uint32_t> _icnLastUsed( ICN::LASTICN, 0 );
+        std::vector<size_t> _icnSize( ICN::LASTICN, 0 );
+        size_t _icnCacheSize = 0;
+
+        std::vector<uint32_t> _tilLastUsed( TIL::LASTTIL, 0 );
+        std::vector<size_t> _tilSize( TIL::LASTTIL, 0 );
+        size_t _tilCacheSize = 0;
+
+        // Regular, scaled and RLE sprites of an ICN are accounted together as they are released together
+        void UpdateICNSize( int id )
+        {
+            size_t size = 0;
+            for ( const Sprite & sprite : _icnVsSprite[id] ) {
+                size += GetImageSize( sprite );
+            }
+
+            std::map<int, std::vector<Sprite> >::const_iterator scaled = _icnVsScaledSprite.find( id );
+            if ( scaled != _icnVsScaledSprite.end() ) {
+                for ( const Sprite & sprite : scaled->second ) {
+                    size += GetImageSize( sprite );
+                }
+            }
+
+            for ( const RLESprite & sprite : _icnVsRLESprite[id] ) {
+                size += sprite.dataSize();
+            }
+
+            _icnCacheSize = _icnCacheSize - _icnSize[id] + size;
+            _icnSize[id] = size;
+        }
+
+        void UpdateTILSize( int id )
+        {
+            size_t size = 0;
+            for ( const std::vector<Image> & shape : _tilVsImage[id] ) {
+                for ( const Image & image : shape ) {
+                    size += GetImageSize( image );
+                }
+            }
+
+            _tilCacheSize = _tilCacheSize - _tilSize[id] + size;
+            _tilSize[id] = size;
+        }
+
+        void ReleaseICN( int id )
+        {
+            std::vector<Sprite>().swap( _icnVsSprite[id] );
+            _icnVsScaledSprite.erase( id );
+            std::vector<RLESprite>().swap( _icnVsRLESprite[id] );
+
+            UpdateICNSize( id );
+        }
+
+        void ReleaseTIL( int id )
+        {
+            std::vector<std::vector<Image> >().swap( _tilVsImage[id] );
+
+            UpdateTILSize( id );
+        }
+
+        // Decodes ICN frames as they are stored in AGG file. The function does not touch any cache so it could be called from any thread.
+        bool DecodeICN( int id, std::vector<Sprite> & sprites )
         {
-            const std::vector<u8> & body = ::AGG::ReadChunk( ICN::GetString( id ) );
+            const AGGChunk body = ::AGG::ReadChunk( ICN::GetString( id ) );
 
             if ( body.empty() ) {
-                return;
+                return false;
             }
 
-            StreamBuf imageStream( body );
+            StreamBuf imageStream( body.data(), body.size() );
 
             const uint32_t count = imageStream.getLE16();
             const uint32_t blockSize = imageStream.getLE32();
             if ( count == 0 || blockSize == 0 ) {
-                return;
+                return false;
             }
 
-            _icnVsSprite[id].resize( count );
+            sprites.resize( count );
 
             for ( uint32_t i = 0; i < count; ++i ) {
                 imageStream.seek( headerSize + i * 13 );
@@ -874,9 +988,240 @@ namespace fheroes2
 
                 const uint8_t * data = body.data() + headerSize + header1.offsetData;
 
-                _icnVsSprite[id][i]
+                sprites[i]
                     = decodeICNSprite( data, sizeData, header1.width, header1.height, static_cast<int16_t>( header1.offsetX ), static_cast<int16_t>( header1.offsetY ) );
             }
+
+            return true;
+        }
+
+        // Same as DecodeICN but for original (not flipped) TIL images.
+        bool DecodeTIL( int id, std::vector<Image> & images )
+        {
+            const AGGChunk data = ::AGG::ReadChunk( TIL::GetString( id ) );
+            if ( data.size() < headerSize ) {
+                return false;
+            }
+
+            StreamBuf buffer( data.data(), data.size() );
+
+            const uint32_t count = buffer.getLE16();
+            const uint32_t width = buffer.getLE16();
+            const uint32_t height = buffer.getLE16();
+            const uint32_t size = width * height;
+            if ( headerSize + count * size != data.size() ) {
+                return false;
+            }
+
+            images.resize( count );
+            for ( uint32_t i = 0; i < count; ++i ) {
+                Image & tilImage = images[i];
+                tilImage.resize( width, height );
+                memcpy( tilImage.image(), data.data() + headerSize + i * size, size );
+                std::fill( tilImage.transform(), tilImage.transform() + width * height, 0 );
+            }
+
+            return true;
+        }
+
+        // Decoding of big ICNs like monster animations takes noticeable time. This class decodes ICNs and TILs which are going to be
+        // needed soon on a separate thread. Decoded resources are kept here until the main thread takes them into the caches.
+        class ResourcePrefetcher
+        {
+        public:
+            ResourcePrefetcher()
+                : _currentICN( -1 )
+                , _currentTIL( -1 )
+                , _resultSize( 0 )
+                , _exitFlag( 0 )
+            {}
+
+            ~ResourcePrefetcher()
+            {
+                if ( _worker ) {
+                    _mutex.lock();
+
+                    _exitFlag = 1;
+                    _workerNotification.notify_all();
+
+                    _mutex.unlock();
+
+                    _worker->join();
+                    _worker.reset();
+                }
+            }
+
+            void push( const std::vector<int> & icnIds, const std::vector<int> & tilIds )
+            {
+                if ( icnIds.empty() && tilIds.empty() ) {
+                    return;
+                }
+
+                if ( !_worker ) {
+                    _worker.reset( new std::thread( ResourcePrefetcher::_workerThread, this ) );
+                }
+
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                for ( const int id : icnIds ) {
+                    if ( id != _currentICN && _icnResults.find( id ) == _icnResults.end() && std::find( _icnTasks.begin(), _icnTasks.end(), id ) == _icnTasks.end() ) {
+                        _icnTasks.push_back( id );
+                    }
+                }
+
+                for ( const int id : tilIds ) {
+                    if ( id != _currentTIL && _tilResults.find( id ) == _tilResults.end() && std::find( _tilTasks.begin(), _tilTasks.end(), id ) == _tilTasks.end() ) {
+                        _tilTasks.push_back( id );
+                    }
+                }
+
+                _workerNotification.notify_all();
+            }
+
+            // Moves prefetched frames of the ICN into the given vector. If the ICN is being decoded at the moment the call waits for it.
+            // Returns false if the ICN has not been prefetched, the caller should decode it by itself then.
+            bool takeICN( int id, std::vector<Sprite> & sprites )
+            {
+                return _take( id, _icnTasks, _currentICN, _icnResults, sprites );
+            }
+
+            bool takeTIL( int id, std::vector<Image> & images )
+            {
+                return _take( id, _tilTasks, _currentTIL, _tilResults, images );
+            }
+
+            // Drops all decoded resources which have not been taken yet. Returns the number of released bytes.
+            size_t clear()
+            {
+                if ( !_worker ) {
+                    return 0;
+                }
+
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                _icnResults.clear();
+                _tilResults.clear();
+
+                const size_t releasedSize = _resultSize;
+                _resultSize = 0;
+                return releasedSize;
+            }
+
+            void info( size_t & count, size_t & size )
+            {
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                count = _icnResults.size() + _tilResults.size();
+                size = _resultSize;
+            }
+
+        private:
+            std::unique_ptr<std::thread> _worker;
+            std::mutex _mutex;
+
+            std::condition_variable _workerNotification;
+            std::condition_variable _masterNotification;
+
+            std::deque<int> _icnTasks;
+            std::deque<int> _tilTasks;
+
+            int _currentICN;
+            int _currentTIL;
+
+            std::map<int, std::vector<Sprite> > _icnResults;
+            std::map<int, std::vector<Image> > _tilResults;
+            size_t _resultSize; // in bytes
+
+            uint8_t _exitFlag;
+
+            template <typename T>
+            bool _take( int id, std::deque<int> & tasks, const int & current, std::map<int, std::vector<T> > & results, std::vector<T> & out )
+            {
+                // Only the main thread starts the worker so no synchronization is needed here.
+                if ( !_worker ) {
+                    return false;
+                }
+
+                std::unique_lock<std::mutex> mutexLock( _mutex );
+
+                // The resource is needed right now: there is no point to wait while the worker reaches it in the queue.
+                std::deque<int>::iterator task = std::find( tasks.begin(), tasks.end(), id );
+                if ( task != tasks.end() ) {
+                    tasks.erase( task );
+                    return false;
+                }
+
+                _masterNotification.wait( mutexLock, [&] { return current != id; } );
+
+                typename std::map<int, std::vector<T> >::iterator result = results.find( id );
+                if ( result == results.end() ) {
+                    return false;
+                }
+
+                for ( const T & image : result->second ) {
+                    _resultSize -= GetImageSize( image );
+                }
+
+                out = std::move( result->second );
+                results.erase( result );
+                return true;
+            }
+
+            template <typename T>
+            static void _processTask( ResourcePrefetcher * prefetcher, std::unique_lock<std::mutex> & mutexLock, std::deque<int> & tasks, int & current,
+                                      std::map<int, std::vector<T> > & results, bool ( *decode )( int, std::vector<T> & ) )
+            {
+                current = tasks.front();
+                tasks.pop_front();
+
+                mutexLock.unlock();
+
+                std::vector<T> images;
+                const bool isDecoded = decode( current, images );
+
+                mutexLock.lock();
+
+                if ( isDecoded ) {
+                    for ( const T & image : images ) {
+                        prefetcher->_resultSize += GetImageSize( image );
+                    }
+
+                    results[current] = std::move( images );
+                }
+
+                current = -1;
+                prefetcher->_masterNotification.notify_all();
+            }
+
+            static void _workerThread( ResourcePrefetcher * prefetcher )
+            {
+                assert( prefetcher != nullptr );
+
+                std::unique_lock<std::mutex> mutexLock( prefetcher->_mutex );
+
+                while ( prefetcher->_exitFlag == 0 ) {
+                    if ( !prefetcher->_icnTasks.empty() ) {
+                        _processTask( prefetcher, mutexLock, prefetcher->_icnTasks, prefetcher->_currentICN, prefetcher->_icnResults, DecodeICN );
+                    }
+                    else if ( !prefetcher->_tilTasks.empty() ) {
+                        _processTask( prefetcher, mutexLock, prefetcher->_tilTasks, prefetcher->_currentTIL, prefetcher->_tilResults, DecodeTIL );
+                    }
+                    else {
+                        prefetcher->_workerNotification.wait( mutexLock );
+                    }
+                }
+            }
+        };
+
+        ResourcePrefetcher _resourcePrefetcher;
+
+        void LoadOriginalICN( int id )
+        {
+            std::vector<Sprite> sprites;
+            if ( _resourcePrefetcher.takeICN( id, sprites ) || DecodeICN( id, sprites ) ) {
+                _icnVsSprite[id] = std::move( sprites );
+                UpdateICNSize( id );
+            }
         }
 
         // Helper function for LoadModifiedICN
@@ -1377,6 +1722,8 @@ namespace fheroes2
                 if ( !LoadModifiedICN( id ) ) {
                     LoadOriginalICN( id );
                 }
+
+                UpdateICNSize( id );
             }
 
             return _icnVsSprite[id].size();
@@ -1387,42 +1734,19 @@ namespace fheroes2
             if ( _tilVsImage[id].empty() ) {
                 _tilVsImage[id].resize( 4 ); // 4 possible sides
 
-                const std::vector<uint8_t> & data = ::AGG::ReadChunk( TIL::GetString( id ) );
-                if ( data.size() < headerSize ) {
-                    return 0;
-                }
-
-                StreamBuf buffer( data );
-
-                const uint32_t count = buffer.getLE16();
-                const uint32_t width = buffer.getLE16();
-                const uint32_t height = buffer.getLE16();
-                const uint32_t size = width * height;
-                if ( headerSize + count * size != data.size() ) {
+                std::vector<Image> & originalTIL = _tilVsImage[id][0];
+                if ( !_resourcePrefetcher.takeTIL( id, originalTIL ) && !DecodeTIL( id, originalTIL ) ) {
                     return 0;
                 }
 
-                std::vector<Image> & originalTIL = _tilVsImage[id][0];
-
-                originalTIL.resize( count );
-                for ( uint32_t i = 0; i < count; ++i ) {
-                    Image & tilImage = originalTIL[i];
-                    tilImage.resize( width, height );
-                    memcpy( tilImage.image(), data.data() + headerSize + i * size, size );
-                    std::fill( tilImage.transform(), tilImage.transform() + width * height, 0 );
-                }
+                const size_t count = originalTIL.size();
 
+                // Flipped tiles are created by GetTIL on the first request as most of them are never used
                 for ( uint32_t shapeId = 1; shapeId < 4; ++shapeId ) {
-                    std::vector<Image> & currentTIL = _tilVsImage[id][shapeId];
-                    currentTIL.resize( count );
-
-                    const bool horizontalFlip = ( shapeId & 2 ) != 0;
-                    const bool verticalFlip = ( shapeId & 1 ) != 0;
-
-                    for ( uint32_t i = 0; i < count; ++i ) {
-                        currentTIL[i] = Flip( originalTIL[i], horizontalFlip, verticalFlip );
-                    }
+                    _tilVsImage[id][shapeId].resize( count );
                 }
+
+                UpdateTILSize( id );
             }
 
             return _tilVsImage[id][0].size();
@@ -1458,6 +1782,8 @@ namespace fheroes2
                 resizedIcn.resize( resizedWidth, resizedHeight );
                 resizedIcn.setPosition( static_cast<int32_t>( originalIcn.x() * scaleFactorX + 0.5 ), static_cast<int32_t>( originalIcn.y() * scaleFactorY + 0.5 ) );
                 Resize( originalIcn, resizedIcn, false );
+
+                UpdateICNSize( icnId );
             }
 
             return resizedIcn;
@@ -1473,6 +1799,8 @@ namespace fheroes2
                 return errorImage;
             }
 
+            _icnLastUsed[icnId] = ::AGG::resource_use_period;
+
             if ( IsScalableICN( icnId ) ) {
                 return GetScaledICN( icnId, index );
             }
@@ -1480,6 +1808,91 @@ namespace fheroes2
             return _icnVsSprite[icnId][index];
         }
 
+        const Sprite & GetICN( int icnId, uint32_t index, const PAL::PaletteType paletteType, const bool flip )
+        {
+            if ( paletteType == PAL::PaletteType::STANDARD && !flip ) {
+                return GetICN( icnId, index );
+            }
+
+            const std::tuple<int, uint32_t, int, bool> key( icnId, index, static_cast<int>( paletteType ), flip );
+            const uint64_t useId = _paletteSpriteCacheHits + _paletteSpriteCacheMisses;
+
+            std::map<std::tuple<int, uint32_t, int, bool>, PaletteSprite>::iterator cached = _icnVsPaletteSprite.find( key );
+            if ( cached != _icnVsPaletteSprite.end() ) {
+                ++_paletteSpriteCacheHits;
+                cached->second.lastUsed = useId;
+                return cached->second.sprite;
+            }
+
+            ++_paletteSpriteCacheMisses;
+
+            const Sprite & original = GetICN( icnId, index );
+            if ( original.empty() ) {
+                return original;
+            }
+
+            PaletteSprite & created = _icnVsPaletteSprite[key];
+            created.lastUsed = useId;
+            created.sprite = flip ? Sprite( Flip( original, true, false ), original.x(), original.y() ) : original;
+            if ( paletteType != PAL::PaletteType::STANDARD ) {
+                ApplyPalette( created.sprite, PAL::GetPalette( paletteType ) );
+            }
+
+            _paletteSpriteCacheSize += GetImageSize( created.sprite );
+
+            // Remove the least recently used sprites except the one which has been just created.
+            while ( _paletteSpriteCacheSize > paletteSpriteCacheLimit && _icnVsPaletteSprite.size() > 1 ) {
+                std::map<std::tuple<int, uint32_t, int, bool>, PaletteSprite>::iterator oldest = _icnVsPaletteSprite.end();
+                for ( std::map<std::tuple<int, uint32_t, int, bool>, PaletteSprite>::iterator it = _icnVsPaletteSprite.begin(); it != _icnVsPaletteSprite.end(); ++it ) {
+                    if ( it->first != key && ( oldest == _icnVsPaletteSprite.end() || it->second.lastUsed < oldest->second.lastUsed ) ) {
+                        oldest = it;
+                    }
+                }
+
+                _paletteSpriteCacheSize -= GetImageSize( oldest->second.sprite );
+                _icnVsPaletteSprite.erase( oldest );
+            }
+
+            DEBUG_LOG( DBG_ENGINE, DBG_TRACE,
+                       "palette sprite cache: " << _icnVsPaletteSprite.size() << " sprites, " << _paletteSpriteCacheSize << " bytes, " << _paletteSpriteCacheHits
+                                                << " hits, " << _paletteSpriteCacheMisses << " misses" );
+
+            return created.sprite;
+        }
+
+        const RLESprite & GetRLEICN( int icnId, uint32_t index )
+        {
+            if ( !IsValidICNId( icnId ) ) {
+                return errorRLEImage;
+            }
+
+            std::vector<RLESprite> & rleSprites = _icnVsRLESprite[icnId];
+            if ( rleSprites.empty() ) {
+                const bool isDecoded = !_icnVsSprite[icnId].empty();
+
+                const uint32_t count = static_cast<uint32_t>( GetMaximumICNIndex( icnId ) );
+                rleSprites.reserve( count );
+                for ( uint32_t i = 0; i < count; ++i ) {
+                    rleSprites.emplace_back( GetICN( icnId, i ) );
+                }
+
+                // Regular sprites decoded only to be encoded are not needed anymore. They are decoded again if somebody asks for them.
+                if ( !isDecoded && !IsScalableICN( icnId ) ) {
+                    std::vector<Sprite>().swap( _icnVsSprite[icnId] );
+                }
+
+                UpdateICNSize( icnId );
+            }
+
+            if ( index >= rleSprites.size() ) {
+                return errorRLEImage;
+            }
+
+            _icnLastUsed[icnId] = ::AGG::resource_use_period;
+
+            return rleSprites[index];
+        }
+
         uint32_t GetICNCount( int icnId )
         {
             if ( !IsValidICNId( icnId ) ) {
@@ -1489,6 +1902,25 @@ namespace fheroes2
             return static_cast<uint32_t>( GetMaximumICNIndex( icnId ) );
         }
 
+        void Prefetch( const std::vector<int> & icnIds, const std::vector<int> & tilIds )
+        {
+            std::vector<int> icnToDecode;
+            for ( const int id : icnIds ) {
+                if ( id != ICN::UNKNOWN && IsValidICNId( id ) && _icnVsSprite[id].empty() && _icnVsRLESprite[id].empty() ) {
+                    icnToDecode.push_back( id );
+                }
+            }
+
+            std::vector<int> tilToDecode;
+            for ( const int id : tilIds ) {
+                if ( id != TIL::UNKNOWN && IsValidTILId( id ) && _tilVsImage[id].empty() ) {
+                    tilToDecode.push_back( id );
+                }
+            }
+
+            _resourcePrefetcher.push( icnToDecode, tilToDecode );
+        }
+
         const Image & GetTIL( int tilId, uint32_t index, uint32_t shapeId )
         {
             if ( shapeId > 3 ) {
@@ -1504,7 +1936,18 @@ namespace fheroes2
                 return errorImage;
             }
 
-            return _tilVsImage[tilId][shapeId][index];
+            _tilLastUsed[tilId] = ::AGG::resource_use_period;
+
+            Image & tilImage = _tilVsImage[tilId][shapeId][index];
+            if ( shapeId > 0 && tilImage.empty() ) {
+                tilImage = Flip( _tilVsImage[tilId][0][index], ( shapeId & 2 ) != 0, ( shapeId & 1 ) != 0 );
+
+                const size_t imageSize = GetImageSize( tilImage );
+                _tilSize[tilId] += imageSize;
+                _tilCacheSize += imageSize;
+            }
+
+            return tilImage;
         }
 
         const Sprite & GetLetter( uint32_t character, uint32_t fontType )
@@ -1559,3 +2002,197 @@ namespace fheroes2
         }
     }
 }
+
+namespace
+{
+    enum class CachedResourceType : int
+    {
+        ICN,
+        TIL,
+        WAV,
+        MID
+    };
+
+    struct CachedResource
+    {
+        CachedResource( CachedResourceType type_, int id_, uint32_t lastUsed_, size_t size_ )
+            : type( type_ )
+            , id( id_ )
+            , lastUsed( lastUsed_ )
+            , size( size_ )
+        {}
+
+        bool operator<( const CachedResource & other ) const
+        {
+            return lastUsed < other.lastUsed;
+        }
+
+        CachedResourceType type;
+        int id;
+        uint32_t lastUsed;
+        size_t size;
+    };
+
+    void AddSoundCandidates( std::vector<CachedResource> & candidates, CachedResourceType type, const std::map<int, std::vector<u8> > & cache,
+                             const std::map<int, uint32_t> & lastUsed, const uint32_t period )
+    {
+        for ( std::map<int, std::vector<u8> >::const_iterator it = cache.begin(); it != cache.end(); ++it ) {
+            if ( it->second.empty() ) {
+                continue;
+            }
+
+            std::map<int, uint32_t>::const_iterator usage = lastUsed.find( it->first );
+            const uint32_t usedPeriod = usage != lastUsed.end() ? usage->second : 0;
+            if ( usedPeriod != period ) {
+                candidates.emplace_back( type, it->first, usedPeriod, it->second.size() );
+            }
+        }
+    }
+
+    void ReleaseSound( std::map<int, std::vector<u8> > & cache, std::map<int, uint32_t> & lastUsed, size_t & cacheSize, int id )
+    {
+        std::map<int, std::vector<u8> >::iterator it = cache.find( id );
+        if ( it != cache.end() ) {
+            cacheSize -= it->second.size();
+            cache.erase( it );
+        }
+
+        lastUsed.erase( id );
+    }
+}
+
+void AGG::ReleaseUnusedResources()
+{
+    // Everything used before this moment belongs to the period which is over now.
+    const uint32_t period = resource_use_period++;
+
+    const size_t budget = static_cast<size_t>( Settings::Get().ResourceCacheSize() ) * 1024 * 1024;
+    if ( budget == 0 ) {
+        return;
+    }
+
+    // Prefetched resources which have not been requested yet take memory as well.
+    size_t prefetchedCount = 0;
+    size_t prefetchedSize = 0;
+    fheroes2::AGG::_resourcePrefetcher.info( prefetchedCount, prefetchedSize );
+
+    size_t totalSize = fheroes2::AGG::_icnCacheSize + fheroes2::AGG::_tilCacheSize + prefetchedSize;
+
+    // Sounds are accessed by the audio thread which could be busy for a while with a long MIDI composition. Do not wait for it.
+    std::unique_lock<std::mutex> audioLock( g_asyncSoundManager.resourceMutex(), std::try_to_lock );
+    if ( audioLock.owns_lock() ) {
+        totalSize += wav_cache_size + mid_cache_size;
+    }
+
+    if ( totalSize <= budget ) {
+        return;
+    }
+
+    // Prefetched resources which have not been requested till now are the first to go.
+    const size_t releasedPrefetchedSize = fheroes2::AGG::_resourcePrefetcher.clear();
+    if ( releasedPrefetchedSize > 0 ) {
+        DEBUG_LOG( DBG_ENGINE, DBG_INFO, "released " << releasedPrefetchedSize << " bytes of prefetched resources" );
+    }
+
+    // The worker could have finished more resources since they were counted, only the counted ones are a part of the total size.
+    totalSize -= prefetchedSize;
+
+    std::vector<CachedResource> candidates;
+
+    for ( size_t id = 0; id < fheroes2::AGG::_icnSize.size(); ++id ) {
+        if ( fheroes2::AGG::_icnSize[id] > 0 && fheroes2::AGG::_icnLastUsed[id] != period ) {
+            candidates.emplace_back( CachedResourceType::ICN, static_cast<int>( id ), fheroes2::AGG::_icnLastUsed[id], fheroes2::AGG::_icnSize[id] );
+        }
+    }
+
+    for ( size_t id = 0; id < fheroes2::AGG::_tilSize.size(); ++id ) {
+        if ( fheroes2::AGG::_tilSize[id] > 0 && fheroes2::AGG::_tilLastUsed[id] != period ) {
+            candidates.emplace_back( CachedResourceType::TIL, static_cast<int>( id ), fheroes2::AGG::_tilLastUsed[id], fheroes2::AGG::_tilSize[id] );
+        }
+    }
+
+    if ( audioLock.owns_lock() ) {
+        AddSoundCandidates( candidates, CachedResourceType::WAV, wav_cache, wav_cache_last_used, period );
+        AddSoundCandidates( candidates, CachedResourceType::MID, mid_cache, mid_cache_last_used, period );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end() );
+
+    size_t releasedCount = 0;
+    size_t releasedSize = 0;
+
+    for ( const CachedResource & resource : candidates ) {
+        if ( totalSize <= budget ) {
+            break;
+        }
+
+        switch ( resource.type ) {
+        case CachedResourceType::ICN:
+            fheroes2::AGG::ReleaseICN( resource.id );
+            break;
+        case CachedResourceType::TIL:
+            fheroes2::AGG::ReleaseTIL( resource.id );
+            break;
+        case CachedResourceType::WAV:
+            ReleaseSound( wav_cache, wav_cache_last_used, wav_cache_size, resource.id );
+            break;
+        case CachedResourceType::MID:
+            ReleaseSound( mid_cache, mid_cache_last_used, mid_cache_size, resource.id );
+            break;
+        default:
+            break;
+        }
+
+        totalSize -= resource.size;
+        releasedSize += resource.size;
+        ++releasedCount;
+    }
+
+    DEBUG_LOG( DBG_ENGINE, DBG_INFO,
+               "released " << releasedCount << " resources, " << releasedSize << " bytes; cache takes " << totalSize << " bytes of " << budget << " allowed" );
+}
+
+std::string AGG::GetCacheInfo()
+{
+    size_t icnCount = 0;
+    for ( const size_t size : fheroes2::AGG::_icnSize ) {
+        if ( size > 0 ) {
+            ++icnCount;
+        }
+    }
+
+    size_t tilCount = 0;
+    for ( const size_t size : fheroes2::AGG::_tilSize ) {
+        if ( size > 0 ) {
+            ++tilCount;
+        }
+    }
+
+    std::ostringstream os;
+    os << "resource cache limit: ";
+    if ( Settings::Get().ResourceCacheSize() > 0 ) {
+        os << Settings::Get().ResourceCacheSize() << " MB";
+    }
+    else {
+        os << "none";
+    }
+
+    os << std::endl << "ICN: " << icnCount << " items, " << fheroes2::AGG::_icnCacheSize << " bytes";
+    os << std::endl << "TIL: " << tilCount << " items, " << fheroes2::AGG::_tilCacheSize << " bytes";
+    os << std::endl
+       << "palette sprites: " << fheroes2::AGG::_icnVsPaletteSprite.size() << " items, " << fheroes2::AGG::_paletteSpriteCacheSize << " bytes of "
+       << fheroes2::AGG::paletteSpriteCacheLimit << " allowed, " << fheroes2::AGG::_paletteSpriteCacheHits << " hits, " << fheroes2::AGG::_paletteSpriteCacheMisses
+       << " misses";
+
+    size_t prefetchedCount = 0;
+    size_t prefetchedSize = 0;
+    fheroes2::AGG::_resourcePrefetcher.info( prefetchedCount, prefetchedSize );
+    os << std::endl << "prefetched: " << prefetchedCount << " items, " << prefetchedSize << " bytes";
+
+    std::lock_guard<std::mutex> mutexLock( g_asyncSoundManager.resourceMutex() );
+
+    os << std::endl << "WAV: " << wav_cache.size() << " items, " << wav_cache_size << " bytes";
+    os << std::endl << "MID: " << mid_cache.size() << " items, " << mid_cache_size << " bytes";
+
+    return os.str();
+}
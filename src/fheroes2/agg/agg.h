@@ -23,6 +23,7 @@
 #ifndef H2AGG_H
 #define H2AGG_H
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -42,11 +43,24 @@ namespace AGG
     void PlaySound( int m82, bool asyncronizedCall = false );
     void PlayMusic( int mus, bool loop = true, bool asyncronizedCall = false );
     void ResetMixer();
+
+    // Releases the least recently used sprites, tiles and sounds while the cache takes more memory than allowed by the settings.
+    // Resources used since the previous call are kept. Call it only at a moment when nobody holds references to cached resources.
+    void ReleaseUnusedResources();
+
+    // Returns the occupancy of resource caches in a human readable form
+    std::string GetCacheInfo();
+}
+
+namespace PAL
+{
+    enum class PaletteType : int;
 }
 
 namespace fheroes2
 {
     class Image;
+    class RLESprite;
     class Sprite;
 
     namespace AGG
@@ -54,6 +68,18 @@ namespace fheroes2
         const Sprite & GetICN( int icnId, uint32_t index );
         uint32_t GetICNCount( int icnId );
 
+        // Starts decoding of the given ICNs and TILs on a background thread so they are ready by the moment somebody asks for them.
+        // Use it before opening a screen which needs many resources at once, like a battle or a castle.
+        void Prefetch( const std::vector<int> & icnIds, const std::vector<int> & tilIds = std::vector<int>() );
+
+        // Returns ICN sprite with applied palette and optionally flipped horizontally. Such sprites are created on the first request and cached.
+        // The cache has a limited size so do not keep the reference for a long time: the sprite could be removed by the next call of this function.
+        const Sprite & GetICN( int icnId, uint32_t index, const PAL::PaletteType paletteType, const bool flip = false );
+
+        // Returns run-length encoded ICN sprite. It takes several times less memory than a regular sprite and it is drawn faster
+        // when most of its pixels are transparent, like monster animation frames.
+        const RLESprite & GetRLEICN( int icnId, uint32_t index );
+
         // shapeId could be 0, 1, 2 or 3 only
         const Image & GetTIL( int tilId, uint32_t index, uint32_t shapeId );
         const Sprite & GetLetter( uint32_t character, uint32_t fontType );
@@ -100,6 +100,7 @@ namespace AI
 
         virtual void Reset();
         virtual void resetPathfinder() = 0;
+        virtual void updatePathfinder( int tileIndex ) = 0;
 
         virtual ~Base() {}
 
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "ai_normal.h"
+#include "heroes.h"
 #include "maps_tiles.h"
 
 namespace AI
@@ -32,6 +33,27 @@ namespace AI
     void Normal::resetPathfinder()
     {
         _pathfinder.reset();
+        _heroPathfinders.clear();
+    }
+
+    void Normal::updatePathfinder( int tileIndex )
+    {
+        _pathfinder.markTileAsChanged( tileIndex );
+
+        for ( auto & heroPathfinder : _heroPathfinders ) {
+            heroPathfinder.second->markTileAsChanged( tileIndex );
+        }
+    }
+
+    AIWorldPathfinder & Normal::getHeroPathfinder( const Heroes & hero )
+    {
+        std::unique_ptr<AIWorldPathfinder> & pathfinder = _heroPathfinders[hero.GetID()];
+        if ( !pathfinder ) {
+            // a hero only needs its latest result
+            pathfinder.reset( new AIWorldPathfinder( ARMY_STRENGTH_ADVANTAGE_MEDUIM, 0 ) );
+            pathfinder->reset();
+        }
+        return *pathfinder;
     }
 
     void Normal::revealFog( const Maps::Tiles & tile )
@@ -21,6 +21,9 @@
 #ifndef H2AI_NORMAL_H
 #define H2AI_NORMAL_H
 
+#include <map>
+#include <memory>
+
 #include "ai.h"
 #include "world_pathfinding.h"
 
@@ -91,13 +94,20 @@ namespace AI
         double getObjectValue( const Heroes & hero, int index, int objectID, double valueToIgnore ) const;
         int getPriorityTarget( const Heroes & hero, double & maxPriority, int patrolIndex = -1, uint32_t distanceLimit = 0 );
         virtual void resetPathfinder() override;
+        virtual void updatePathfinder( int tileIndex ) override;
 
     private:
+        // Read-only part of getPriorityTarget, safe to run for several heroes at once as long as the world doesn't change
+        int getPriorityTarget( AIWorldPathfinder & pathfinder, const Heroes & hero, double & maxPriority, int patrolIndex, uint32_t distanceLimit ) const;
+        AIWorldPathfinder & getHeroPathfinder( const Heroes & hero );
+
         // following data won't be saved/serialized
         double _combinedHeroStrength = 0;
         std::vector<IndexObject> _mapObjects;
         std::vector<RegionStats> _regions;
         AIWorldPathfinder _pathfinder;
+        // each hero of the current kingdom has its own pathfinder so that heroes can be evaluated in parallel
+        std::map<int, std::unique_ptr<AIWorldPathfinder> > _heroPathfinders;
         BattlePlanner _battlePlanner;
     };
 }
@@ -26,6 +26,7 @@
 #include "logging.h"
 #include "maps.h"
 #include "mp2.h"
+#include "thread_pool.h"
 #include "world.h"
 
 namespace
@@ -35,6 +36,11 @@ namespace
         Heroes * hero = nullptr;
         int patrolCenter = -1;
         uint32_t patrolDistance = 0;
+
+        // planning results
+        AIWorldPathfinder * pathfinder = nullptr;
+        int targetIndex = -1;
+        double priority = -1;
     };
 
     // Used for caching object validations per hero.
@@ -205,7 +211,9 @@ namespace AI
             return value;
         }
         else if ( objectID == MP2::OBJ_WHIRLPOOL ) {
-            const MapsIndexes & list = world.GetWhirlpoolEndPoints( index );
+            // Heroes are evaluated in parallel so no random number can be drawn here. Older versions checked one random exit,
+            // so the random sequence and AI turns differ from them.
+            const MapsIndexes & list = world.getAllWhirlpoolExits( index );
             for ( const int whirlpoolIndex : list ) {
                 if ( world.GetTiles( whirlpoolIndex ).isFog( hero.GetColor() ) )
                     return -3000.0;
@@ -248,6 +256,11 @@ namespace AI
     }
 
     int AI::Normal::getPriorityTarget( const Heroes & hero, double & maxPriority, int patrolIndex, uint32_t distanceLimit )
+    {
+        return getPriorityTarget( _pathfinder, hero, maxPriority, patrolIndex, distanceLimit );
+    }
+
+    int AI::Normal::getPriorityTarget( AIWorldPathfinder & pathfinder, const Heroes & hero, double & maxPriority, int patrolIndex, uint32_t distanceLimit ) const
     {
         const double lowestPossibleValue = -1.0 * Maps::Ground::slowestMovePenalty * world.getSize();
         const bool heroInPatrolMode = patrolIndex != -1;
@@ -255,12 +268,9 @@ namespace AI
 
         int priorityTarget = -1;
         maxPriority = lowestPossibleValue;
-#ifdef WITH_DEBUG
-        int objectID = MP2::OBJ_ZERO;
-#endif
 
         // pre-cache the pathfinder
-        _pathfinder.reEvaluateIfNeeded( hero );
+        pathfinder.reEvaluateIfNeeded( hero );
 
         const uint32_t leftMovePoints = hero.GetMovePoints();
 
@@ -275,13 +285,13 @@ namespace AI
                 continue;
 
             if ( objectValidator.isValid( node.first ) ) {
-                uint32_t dist = _pathfinder.getDistance( node.first );
+                uint32_t dist = pathfinder.getDistance( node.first );
                 if ( dist == 0 )
                     continue;
 
                 double value = valueStorage.value( node );
 
-                const std::vector<IndexObject> & list = _pathfinder.getObjectsOnTheWay( node.first );
+                const std::vector<IndexObject> & list = pathfinder.getObjectsOnTheWay( node.first );
                 for ( const IndexObject & pair : list ) {
                     if ( objectValidator.isValid( pair.first ) && std::binary_search( _mapObjects.begin(), _mapObjects.end(), pair ) )
                         value += valueStorage.value( pair );
@@ -300,23 +310,13 @@ namespace AI
                 if ( dist && value > maxPriority ) {
                     maxPriority = value;
                     priorityTarget = node.first;
-#ifdef WITH_DEBUG
-                    objectID = node.second;
-#endif
-
-                    DEBUG_LOG( DBG_AI, DBG_TRACE,
-                               hero.GetName() << ": valid object at " << node.first << " value is " << value << " (" << MP2::StringObject( node.second ) << ")" );
                 }
             }
         }
 
-        if ( priorityTarget != -1 ) {
-            DEBUG_LOG( DBG_AI, DBG_INFO,
-                       hero.GetName() << ": priority selected: " << priorityTarget << " value is " << maxPriority << " (" << MP2::StringObject( objectID ) << ")" );
-        }
-        else if ( !heroInPatrolMode ) {
-            priorityTarget = _pathfinder.getFogDiscoveryTile( hero );
-            DEBUG_LOG( DBG_AI, DBG_INFO, hero.GetName() << " can't find an object. Scouting the fog of war at " << priorityTarget );
+        // no logging here: this code runs on worker threads, HeroesTurn logs the results
+        if ( priorityTarget == -1 && !heroInPatrolMode ) {
+            priorityTarget = pathfinder.getFogDiscoveryTile( hero );
         }
 
         return priorityTarget;
@@ -363,13 +363,27 @@ namespace AI
             double maxPriority = 0;
             int bestTargetIndex = -1;
 
+            // Planning doesn't change the world so heroes are evaluated in parallel. Every hero uses its own pathfinder
+            // and the best one is chosen in the original order, so the result doesn't depend on thread scheduling.
             for ( HeroToMove & heroInfo : availableHeroes ) {
-                double priority = -1;
-                const int targetIndex = getPriorityTarget( *heroInfo.hero, priority, heroInfo.patrolCenter, heroInfo.patrolDistance );
-                if ( targetIndex != -1 && ( priority > maxPriority || bestTargetIndex == -1 ) ) {
-                    maxPriority = priority;
-                    bestTargetIndex = targetIndex;
+                heroInfo.pathfinder = &getHeroPathfinder( *heroInfo.hero );
+            }
+
+            fheroes2::ThreadPool::Get().runTasks( availableHeroes.size(), [this, &availableHeroes]( size_t taskId, size_t ) {
+                HeroToMove & heroInfo = availableHeroes[taskId];
+                heroInfo.targetIndex
+                    = getPriorityTarget( *heroInfo.pathfinder, *heroInfo.hero, heroInfo.priority, heroInfo.patrolCenter, heroInfo.patrolDistance );
+            } );
+
+            AIWorldPathfinder * bestPathfinder = nullptr;
+            for ( HeroToMove & heroInfo : availableHeroes ) {
+                DEBUG_LOG( DBG_AI, DBG_INFO, heroInfo.hero->GetName() << ": priority selected: " << heroInfo.targetIndex << " value is " << heroInfo.priority );
+
+                if ( heroInfo.targetIndex != -1 && ( heroInfo.priority > maxPriority || bestTargetIndex == -1 ) ) {
+                    maxPriority = heroInfo.priority;
+                    bestTargetIndex = heroInfo.targetIndex;
                     bestHero = heroInfo.hero;
+                    bestPathfinder = heroInfo.pathfinder;
                 }
             }
 
@@ -378,8 +392,8 @@ namespace AI
                 break;
             }
 
-            _pathfinder.reEvaluateIfNeeded( *bestHero );
-            bestHero->GetPath().setPath( _pathfinder.buildPath( bestTargetIndex ), bestTargetIndex );
+            bestPathfinder->reEvaluateIfNeeded( *bestHero );
+            bestHero->GetPath().setPath( bestPathfinder->buildPath( bestTargetIndex ), bestTargetIndex );
             const int32_t idxToErase = bestHero->GetPath().GetDestinationIndex();
 
             HeroesMove( *bestHero );
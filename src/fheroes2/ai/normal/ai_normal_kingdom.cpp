@@ -23,7 +23,6 @@
 #include "agg.h"
 #include "ai_normal.h"
 #include "game_interface.h"
-#include "ground.h"
 #include "kingdom.h"
 #include "logging.h"
 #include "mus.h"
@@ -60,9 +59,12 @@ namespace AI
         _regions.resize( world.getRegionCount() );
 
         for ( int idx = 0; idx < mapSize; ++idx ) {
-            const Maps::Tiles & tile = world.GetTiles( idx );
-            int objectID = tile.GetObject();
+            // most of the tiles have no action objects, skip them without touching the whole tile data
+            const int objectID = world.getTileInfo( idx ).object;
+            if ( !Kingdom::isKingdomObjectType( objectID ) )
+                continue;
 
+            const Maps::Tiles & tile = world.GetTiles( idx );
             if ( !kingdom.isValidKingdomObject( tile, objectID ) )
                 continue;
 
@@ -138,32 +140,48 @@ namespace AI
         const uint32_t threatDistanceLimit = 2500; // 25 tiles, roughly how much maxed out hero can move in a turn
         std::set<int> castlesInDanger;
 
+        // collect castles each enemy army could threaten, precise distances are calculated for all of them at once
+        std::vector<ArmyDistanceRequest> threatChecks;
+        const RegionGraph & regionGraph = world.getRegionGraph();
+
         for ( auto enemy = enemyArmies.begin(); enemy != enemyArmies.end(); ++enemy ) {
             if ( enemy->second == nullptr )
                 continue;
 
             const double attackerStrength = enemy->second->GetStrength();
+            ArmyDistanceRequest request( enemy->first, attackerStrength );
 
             for ( size_t idx = 0; idx < castles.size(); ++idx ) {
                 const Castle * castle = castles[idx];
                 if ( castle ) {
                     const int castleIndex = castle->GetIndex();
-                    // skip precise distance check if army is too far away to be a threat
-                    if ( Maps::GetApproximateDistance( enemy->first, castleIndex ) * Maps::Ground::roadPenalty > threatDistanceLimit )
+                    // skip precise distance check if army is too far away to be a threat, estimate is never higher than the real distance
+                    if ( regionGraph.getDistanceEstimate( enemy->first, castleIndex ) >= threatDistanceLimit )
                         continue;
 
                     const double defenders = castle->GetArmy().GetStrength();
 
                     const double attackerThreat = attackerStrength - defenders;
                     if ( attackerThreat > 0 ) {
-                        const uint32_t dist = _pathfinder.getDistance( enemy->first, castleIndex, color, attackerStrength );
-                        if ( dist && dist < threatDistanceLimit ) {
-                            // castle is under threat
-                            castlesInDanger.insert( castleIndex );
-                        }
+                        request.targets.push_back( castleIndex );
                     }
                 }
             }
+
+            if ( !request.targets.empty() )
+                threatChecks.push_back( std::move( request ) );
+        }
+
+        _pathfinder.getDistances( threatChecks, color );
+
+        for ( const ArmyDistanceRequest & request : threatChecks ) {
+            for ( size_t idx = 0; idx < request.targets.size(); ++idx ) {
+                const uint32_t dist = request.distances[idx];
+                if ( dist && dist < threatDistanceLimit ) {
+                    // castle is under threat
+                    castlesInDanger.insert( request.targets[idx] );
+                }
+            }
         }
 
         int32_t heroLimit = world.w() / Maps::SMALL + 1;
@@ -250,5 +268,8 @@ namespace AI
                 CastleTurn( **it, std::find( castlesInDanger.begin(), castlesInDanger.end(), ( *it )->GetIndex() ) != castlesInDanger.end() );
             }
         }
+
+        // pathfinders of this kingdom's heroes aren't needed until its next turn
+        _heroPathfinders.clear();
     }
 }
@@ -967,7 +967,9 @@ void Army::setFromTile( const Maps::Tiles & tile )
 
     default:
         if ( isCaptureObject ) {
-            CapturedObject & co = world.GetCapturedObject( tile.GetIndex() );
+            // this code runs from pathfinder and AI worker threads so the world must be accessed through the read-only lookup
+            const World & constWorld = world;
+            const CapturedObject & co = constWorld.GetCapturedObject( tile.GetIndex() );
             const Troop & troop = co.GetTroop();
 
             switch ( co.GetSplit() ) {
@@ -71,6 +71,9 @@ namespace Battle
 
     Result Loader( Army &, Army &, s32 );
 
+    // Number of battles fought since the start of the program
+    uint32_t GetBattleCount( void );
+
     struct TargetInfo
     {
         Unit * defender;
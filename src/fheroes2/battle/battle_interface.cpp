@@ -43,6 +43,7 @@
 #include "pal.h"
 #include "race.h"
 #include "rand.h"
+#include "render_profiler.h"
 #include "ui_window.h"
 #include "world.h"
 
@@ -1060,6 +1061,8 @@ void Battle::Interface::Redraw( void )
 
 void Battle::Interface::RedrawPartialStart()
 {
+    RENDER_PROFILE( BATTLE );
+
     Cursor::Get().Hide();
     RedrawCover();
     RedrawArmies();
@@ -1085,8 +1088,12 @@ void Battle::Interface::RedrawPartialFinish()
     }
 #endif
 
-    fheroes2::Blit( _mainSurface, display, _interfacePosition.x, _interfacePosition.y );
-    RedrawInterface();
+    {
+        RENDER_PROFILE( BATTLE );
+
+        fheroes2::Blit( _mainSurface, display, _interfacePosition.x, _interfacePosition.y );
+        RedrawInterface();
+    }
 
     Cursor::Get().Show();
     display.render();
@@ -1378,7 +1385,8 @@ void Battle::Interface::RedrawOpponentsFlags( void )
     }
 }
 
-fheroes2::Point GetTroopPosition( const Battle::Unit & unit, const fheroes2::Sprite & sprite )
+template <typename SpriteType>
+fheroes2::Point GetTroopPosition( const Battle::Unit & unit, const SpriteType & sprite )
 {
     const Rect & rt = unit.GetRectPosition();
 
@@ -1405,48 +1413,66 @@ fheroes2::Point GetTroopPosition( const Battle::Unit & unit, const fheroes2::Spr
     return fheroes2::Point( offsetX, offsetY );
 }
 
+const fheroes2::Sprite & Battle::Interface::GetMonsterContour( int icnId, uint32_t frameId )
+{
+    MonsterContour & contour = _monsterContours[std::make_pair( icnId, frameId )];
+
+    if ( contour.sprite.empty() ) {
+        // restore the frame from its run-length encoded version to avoid loading regular sprites of the whole monster
+        const fheroes2::RLESprite & encoded = fheroes2::AGG::GetRLEICN( icnId, frameId );
+        fheroes2::Sprite original( encoded.width(), encoded.height(), encoded.x(), encoded.y() );
+        original.reset();
+        fheroes2::Blit( encoded, original, 0, 0 );
+
+        contour.sprite = fheroes2::Sprite( fheroes2::CreateContour( original, _contourColor ), original.x(), original.y() );
+        contour.color = _contourColor;
+    }
+    else if ( contour.color != _contourColor ) {
+        // contour color is cycling so there is no need to create the contour again
+        fheroes2::ReplaceColorId( contour.sprite, contour.color, _contourColor );
+        contour.color = _contourColor;
+    }
+
+    return contour.sprite;
+}
+
 void Battle::Interface::RedrawTroopSprite( const Unit & b )
 {
     const Monster::monstersprite_t & msi = b.GetMonsterSprite();
-    fheroes2::Sprite spmon1;
-    fheroes2::Sprite spmon2;
-
-    PAL::PaletteType applyPalette = PAL::PaletteType::STANDARD;
+    const fheroes2::Sprite * spmon1 = NULL;
+    const fheroes2::Sprite * spmon2 = NULL;
+    // regular monster frames are run-length encoded as most of their pixels are transparent
+    const fheroes2::RLESprite * encodedSprite = NULL;
 
     if ( b_current_sprite && _currentUnit == &b ) {
-        spmon1 = *b_current_sprite;
+        spmon1 = b_current_sprite;
     }
     else if ( b.Modes( SP_STONE ) ) { // under medusa's stunning effect
-        spmon1 = fheroes2::AGG::GetICN( msi.icn_file, b.GetFrame() );
-        applyPalette = PAL::PaletteType::GRAY;
+        spmon1 = &fheroes2::AGG::GetICN( msi.icn_file, b.GetFrame(), PAL::PaletteType::GRAY );
     }
     else {
         // regular
-        spmon1 = fheroes2::AGG::GetICN( msi.icn_file, b.GetFrame() );
+        if ( b.Modes( CAP_MIRRORIMAGE ) ) {
+            spmon1 = &fheroes2::AGG::GetICN( msi.icn_file, b.GetFrame(), PAL::PaletteType::MIRROR_IMAGE );
+        }
+        else {
+            encodedSprite = &fheroes2::AGG::GetRLEICN( msi.icn_file, b.GetFrame() );
+        }
 
         // this unit's turn, must be covered with contour
         if ( _currentUnit == &b ) {
-            if ( b_current_sprite ) {
-                spmon1 = *b_current_sprite;
-            }
-            else {
-                spmon2 = fheroes2::CreateContour( spmon1, _contourColor );
-            }
-        }
-
-        if ( b.Modes( CAP_MIRRORIMAGE ) ) {
-            applyPalette = PAL::PaletteType::MIRROR_IMAGE;
+            spmon2 = &GetMonsterContour( msi.icn_file, b.GetFrame() );
         }
     }
 
-    if ( !spmon1.empty() ) {
+    if ( encodedSprite != NULL ? !encodedSprite->empty() : !spmon1->empty() ) {
         const Rect & rt = b.GetRectPosition();
-        fheroes2::Point sp = GetTroopPosition( b, spmon1 );
+        fheroes2::Point sp = encodedSprite != NULL ? GetTroopPosition( b, *encodedSprite ) : GetTroopPosition( b, *spmon1 );
 
         // move offset
         if ( _movingUnit == &b ) {
-            const fheroes2::Sprite & spmon0 = fheroes2::AGG::GetICN( msi.icn_file, _movingUnit->animation.firstFrame() );
-            const s32 ox = spmon1.x() - spmon0.x();
+            const fheroes2::RLESprite & spmon0 = fheroes2::AGG::GetRLEICN( msi.icn_file, _movingUnit->animation.firstFrame() );
+            const s32 ox = ( encodedSprite != NULL ? encodedSprite->x() : spmon1->x() ) - spmon0.x();
 
             if ( _movingUnit->animation.animationLength() ) {
                 const int32_t cx = _movingPos.x - rt.x;
@@ -1472,15 +1498,16 @@ void Battle::Interface::RedrawTroopSprite( const Unit & b )
             sp.y += cy + static_cast<int32_t>( ( _movingPos.y - _flyingPos.y ) * movementProgress );
         }
 
-        if ( applyPalette != PAL::PaletteType::STANDARD ) {
-            fheroes2::ApplyPalette( spmon1, PAL::GetPalette( applyPalette ) );
+        if ( encodedSprite != NULL ) {
+            fheroes2::AlphaBlit( *encodedSprite, _mainSurface, sp.x, sp.y, b.GetCustomAlpha(), b.isReflect() );
+        }
+        else {
+            fheroes2::AlphaBlit( *spmon1, _mainSurface, sp.x, sp.y, b.GetCustomAlpha(), b.isReflect() );
         }
-
-        fheroes2::AlphaBlit( spmon1, _mainSurface, sp.x, sp.y, b.GetCustomAlpha(), b.isReflect() );
 
         // contour
-        if ( !spmon2.empty() )
-            fheroes2::Blit( spmon2, _mainSurface, sp.x, sp.y, b.isReflect() );
+        if ( spmon2 != NULL && !spmon2->empty() )
+            fheroes2::Blit( *spmon2, _mainSurface, sp.x, sp.y, b.isReflect() );
     }
 }
 
@@ -1816,31 +1843,31 @@ void Battle::Interface::RedrawLowObjects( s32 cell_index )
     if ( cell == NULL )
         return;
 
-    fheroes2::Sprite sprite;
+    const fheroes2::Sprite * sprite = NULL;
 
     switch ( cell->GetObject() ) {
     case 0x84:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0004, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0004, 0 );
         break;
     case 0x87:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0007, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0007, 0 );
         break;
     case 0x90:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0016, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0016, 0 );
         break;
     case 0x9E:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0030, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0030, 0 );
         break;
     case 0x9F:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0031, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0031, 0 );
         break;
     default:
         break;
     }
 
-    if ( !sprite.empty() ) {
+    if ( sprite != NULL && !sprite->empty() ) {
         const Rect & pt = cell->GetPos();
-        fheroes2::Blit( sprite, _mainSurface, pt.x + pt.w / 2 + sprite.x(), pt.y + pt.h + sprite.y() + cellYOffset );
+        fheroes2::Blit( *sprite, _mainSurface, pt.x + pt.w / 2 + sprite->x(), pt.y + pt.h + sprite->y() + cellYOffset );
     }
 }
 
@@ -1850,98 +1877,98 @@ void Battle::Interface::RedrawHighObjects( s32 cell_index )
     if ( cell == NULL )
         return;
 
-    fheroes2::Sprite sprite;
+    const fheroes2::Sprite * sprite = NULL;
 
     switch ( cell->GetObject() ) {
     case 0x80:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0000, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0000, 0 );
         break;
     case 0x81:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0001, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0001, 0 );
         break;
     case 0x82:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0002, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0002, 0 );
         break;
     case 0x83:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0003, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0003, 0 );
         break;
     case 0x85:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0005, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0005, 0 );
         break;
     case 0x86:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0006, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0006, 0 );
         break;
     case 0x88:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0008, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0008, 0 );
         break;
     case 0x89:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0009, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0009, 0 );
         break;
     case 0x8A:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0010, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0010, 0 );
         break;
     case 0x8B:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0011, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0011, 0 );
         break;
     case 0x8C:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0012, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0012, 0 );
         break;
     case 0x8D:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0013, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0013, 0 );
         break;
     case 0x8E:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0014, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0014, 0 );
         break;
     case 0x8F:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0015, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0015, 0 );
         break;
     case 0x91:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0017, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0017, 0 );
         break;
     case 0x92:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0018, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0018, 0 );
         break;
     case 0x93:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0019, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0019, 0 );
         break;
     case 0x94:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0020, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0020, 0 );
         break;
     case 0x95:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0021, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0021, 0 );
         break;
     case 0x96:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0022, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0022, 0 );
         break;
     case 0x97:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0023, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0023, 0 );
         break;
     case 0x98:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0024, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0024, 0 );
         break;
     case 0x99:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0025, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0025, 0 );
         break;
     case 0x9A:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0026, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0026, 0 );
         break;
     case 0x9B:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0027, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0027, 0 );
         break;
     case 0x9C:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0028, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0028, 0 );
         break;
     case 0x9D:
-        sprite = fheroes2::AGG::GetICN( ICN::COBJ0029, 0 );
+        sprite = &fheroes2::AGG::GetICN( ICN::COBJ0029, 0 );
         break;
     default:
         break;
     }
 
-    if ( !sprite.empty() ) {
+    if ( sprite != NULL && !sprite->empty() ) {
         // const Point & topleft = border.GetArea();
         const Rect & pt = cell->GetPos();
-        fheroes2::Blit( sprite, _mainSurface, pt.x + pt.w / 2 + sprite.x(), pt.y + pt.h + sprite.y() + cellYOffset );
+        fheroes2::Blit( *sprite, _mainSurface, pt.x + pt.w / 2 + sprite->x(), pt.y + pt.h + sprite->y() + cellYOffset );
     }
 }
 
@@ -2104,6 +2131,9 @@ void Battle::Interface::HumanTurn( const Unit & b, Actions & a )
     ResetIdleTroopAnimation();
 
     while ( !humanturn_exit && le.HandleEvents() ) {
+        // Battle sprites are not referenced between iterations of this loop.
+        AGG::ReleaseUnusedResources();
+
         // move cursor
         int32_t indexNew = -1;
         if ( le.MouseCursor( Rect( _interfacePosition.x, _interfacePosition.y, _interfacePosition.w, _interfacePosition.h - status.h ) ) ) {
@@ -2746,7 +2776,7 @@ void Battle::Interface::RedrawActionAttackPart1( Unit & attacker, Unit & defende
 
     // long distance attack animation
     if ( archer ) {
-        const fheroes2::Sprite & attackerSprite = fheroes2::AGG::GetICN( attacker.GetMonsterSprite().icn_file, attacker.GetFrame() );
+        const fheroes2::RLESprite & attackerSprite = fheroes2::AGG::GetRLEICN( attacker.GetMonsterSprite().icn_file, attacker.GetFrame() );
         const fheroes2::Point attackerPos = GetTroopPosition( attacker, attackerSprite );
 
         // For shooter position we need bottom center position of rear tile
@@ -3423,7 +3453,7 @@ void Battle::Interface::RedrawActionLuck( const Unit & unit )
     Cursor::Get().SetThemes( Cursor::WAR_POINTER );
     if ( isGoodLuck ) {
         const fheroes2::Sprite & luckSprite = fheroes2::AGG::GetICN( ICN::EXPMRL, 0 );
-        const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( unit.GetMonsterSprite().icn_file, unit.GetFrame() );
+        const fheroes2::RLESprite & unitSprite = fheroes2::AGG::GetRLEICN( unit.GetMonsterSprite().icn_file, unit.GetFrame() );
 
         int width = 2;
         fheroes2::Rect src( 0, 0, width, luckSprite.height() );
@@ -3697,8 +3727,8 @@ void Battle::Interface::RedrawActionMirrorImageSpell( const Unit & target, const
     LocalEvent & le = LocalEvent::Get();
 
     const Monster::monstersprite_t & msi = target.GetMonsterSprite();
-    fheroes2::Sprite sprite = fheroes2::AGG::GetICN( msi.icn_file, target.GetFrame() );
-    fheroes2::ApplyPalette( sprite, PAL::GetPalette( PAL::PaletteType::MIRROR_IMAGE ) );
+    // keep a copy as the cached sprite could be removed by other units while redrawing
+    const fheroes2::Sprite sprite = fheroes2::AGG::GetICN( msi.icn_file, target.GetFrame(), PAL::PaletteType::MIRROR_IMAGE );
 
     const Rect & rt1 = target.GetRectPosition();
     const Rect & rt2 = pos.GetRect();
@@ -3933,8 +3963,7 @@ void Battle::Interface::RedrawActionStoneSpell( const Unit & target )
     const Monster::monstersprite_t & msi = target.GetMonsterSprite();
     const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( msi.icn_file, target.GetFrame() );
 
-    fheroes2::Sprite stoneEffect( unitSprite );
-    fheroes2::ApplyPalette( stoneEffect, PAL::GetPalette( PAL::PaletteType::GRAY ) );
+    const fheroes2::Sprite stoneEffect( fheroes2::AGG::GetICN( msi.icn_file, target.GetFrame(), PAL::PaletteType::GRAY ) );
 
     fheroes2::Sprite mixSprite( unitSprite );
 
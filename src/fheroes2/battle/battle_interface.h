@@ -23,6 +23,7 @@
 #ifndef H2BATTLE_INTERFACE_H
 #define H2BATTLE_INTERFACE_H
 
+#include <map>
 #include <string>
 
 #include "battle_board.h"
@@ -281,6 +282,7 @@ namespace Battle
         bool IdleTroopsAnimation( void );
         void ResetIdleTroopAnimation( void );
         void UpdateContourColor();
+        const fheroes2::Sprite & GetMonsterContour( int icnId, uint32_t frameId );
         void CheckGlobalEvents( LocalEvent & );
 
         void ProcessingHeroDialogResult( int, Actions & );
@@ -334,6 +336,16 @@ namespace Battle
         const Unit * _movingUnit;
         const Unit * _flyingUnit;
         const fheroes2::Sprite * b_current_sprite;
+
+        // Contours of monster sprites. They are created on the first use and kept until the end of the battle.
+        struct MonsterContour
+        {
+            fheroes2::Sprite sprite;
+            uint8_t color = 0;
+        };
+
+        std::map<std::pair<int, uint32_t>, MonsterContour> _monsterContours;
+
         Point _movingPos;
         Point _flyingPos;
 
@@ -46,6 +46,29 @@ namespace Battle
     void NecromancySkillAction( HeroBase &, u32, bool );
 }
 
+namespace
+{
+    uint32_t battleCount = 0;
+
+    void AddArmyICNs( const Army & army, std::vector<int> & icnIds )
+    {
+        for ( size_t i = 0; i < army.Size(); ++i ) {
+            const Troop * troop = army.GetTroop( i );
+            if ( troop == nullptr || !troop->isValid() )
+                continue;
+
+            icnIds.push_back( troop->GetMonsterSprite().icn_file );
+            if ( troop->isArchers() )
+                icnIds.push_back( static_cast<int>( Monster::GetMissileICN( troop->GetID() ) ) );
+        }
+    }
+}
+
+uint32_t Battle::GetBattleCount( void )
+{
+    return battleCount;
+}
+
 Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
 {
     // Validate the arguments - check if battle should even load
@@ -63,6 +86,8 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
         return result;
     }
 
+    ++battleCount;
+
     // pre battle army1
     if ( army1.GetCommander() ) {
         if ( army1.GetCommander()->isCaptain() )
@@ -91,9 +116,16 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
         showBattle = true;
 #endif
 
-    if ( showBattle )
+    if ( showBattle ) {
         AGG::ResetMixer();
 
+        // Monster animations are decoded while the arena is being prepared.
+        std::vector<int> icnIds;
+        AddArmyICNs( army1, icnIds );
+        AddArmyICNs( army2, icnIds );
+        fheroes2::AGG::Prefetch( icnIds );
+    }
+
     Arena arena( army1, army2, mapsindex, showBattle );
 
     DEBUG_LOG( DBG_BATTLE, DBG_INFO, "army1 " << army1.String() );
@@ -1797,7 +1797,7 @@ Point Battle::Unit::GetBackPoint( void ) const
 
 Point Battle::Unit::GetCenterPoint() const
 {
-    const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( GetMonsterSprite().icn_file, GetFrame() );
+    const fheroes2::RLESprite & sprite = fheroes2::AGG::GetRLEICN( GetMonsterSprite().icn_file, GetFrame() );
 
     const Rect & pos = position.GetRect();
     const s32 centerY = pos.y + pos.h + sprite.y() / 2 - 10;
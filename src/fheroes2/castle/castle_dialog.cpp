@@ -189,6 +189,14 @@ int Castle::OpenDialog( bool readonly )
     if ( conf.ExtGameDynamicInterface() )
         conf.SetEvilInterface( ( GetRace() & ( Race::BARB | Race::WRLK | Race::NECR ) ) != 0 );
 
+    // Images of built buildings are decoded while the rest of the dialog is being prepared.
+    std::vector<int> buildingICNs;
+    for ( uint32_t build = BUILD_THIEVESGUILD; build != BUILD_NOTHING; build <<= 1 ) {
+        if ( isBuild( build ) )
+            buildingICNs.push_back( GetICNBuilding( build, GetRace() ) );
+    }
+    fheroes2::AGG::Prefetch( buildingICNs );
+
     CastleHeroes heroes = world.GetHeroes( *this );
 
     // cursor
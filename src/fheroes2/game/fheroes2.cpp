@@ -38,6 +38,7 @@
 #include "gamedefs.h"
 #include "localevent.h"
 #include "logging.h"
+#include "render_profiler.h"
 #include "screen.h"
 #include "system.h"
 #include "translations.h"
@@ -263,6 +264,10 @@ int main( int argc, char ** argv )
             ERROR_LOG( "Exception '" << ex.what() << "' occured during application runtime." );
         }
 
+#ifdef WITH_RENDER_PROFILING
+    fheroes2::RenderProfiler::SaveCSV( System::ConcatePath( System::GetHomeDirectory( "fheroes2" ), "render_profile.csv" ) );
+#endif
+
     fheroes2::Display::instance().release();
 
     return EXIT_SUCCESS;
@@ -125,6 +125,7 @@ namespace Game
         EVENT_DEFAULT_RIGHT,
         EVENT_SYSTEM_FULLSCREEN,
         EVENT_SYSTEM_SCREENSHOT,
+        EVENT_SYSTEM_CACHE_INFO,
         EVENT_SLEEPHERO,
         EVENT_ENDTURN,
         EVENT_NEXTHERO,
@@ -24,6 +24,7 @@
 #include <ctime>
 #include <sstream>
 
+#include "agg.h"
 #include "game.h"
 #include "game_interface.h"
 #include "gamedefs.h"
@@ -87,6 +88,8 @@ const char * Game::EventsName( int evnt )
         return "system fullscreen";
     case EVENT_SYSTEM_SCREENSHOT:
         return "system screenshot";
+    case EVENT_SYSTEM_CACHE_INFO:
+        return "system cache info";
 
     case EVENT_SLEEPHERO:
         return "sleep hero";
@@ -203,6 +206,7 @@ void Game::HotKeysDefaults( void )
     // system
     key_events[EVENT_SYSTEM_FULLSCREEN] = KEY_F4;
     key_events[EVENT_SYSTEM_SCREENSHOT] = KEY_PRINT;
+    key_events[EVENT_SYSTEM_CACHE_INFO] = KEY_F12;
 
     // battle
     key_events[EVENT_BATTLE_CASTSPELL] = KEY_c;
@@ -316,5 +320,8 @@ void Game::KeyboardGlobalFilter( int sym, int mod )
         conf.setFullScreen( fheroes2::engine().isFullScreen() );
         conf.Save( "fheroes2.cfg" );
     }
+    else if ( sym == key_events[EVENT_SYSTEM_CACHE_INFO] ) {
+        VERBOSE_LOG( AGG::GetCacheInfo() );
+    }
     // DEBUG_LOG( DBG_GAME, DBG_INFO, "save: " << stream.str() );
 }
@@ -29,6 +29,7 @@
 #include "game_interface.h"
 #include "maps.h"
 #include "mp2.h"
+#include "render_profiler.h"
 #include "settings.h"
 #include "ui_tool.h"
 #include "world.h"
@@ -184,6 +185,8 @@ void Interface::Basic::Redraw( int force )
     if ( ( hideInterface && conf.ShowRadar() ) || ( combinedRedraw & REDRAW_RADAR ) )
         radar.Redraw();
 
+    RENDER_PROFILE( INTERFACE );
+
     if ( ( hideInterface && conf.ShowIcons() ) || ( combinedRedraw & REDRAW_ICONS ) )
         iconsPanel.Redraw();
     else if ( combinedRedraw & REDRAW_HEROES )
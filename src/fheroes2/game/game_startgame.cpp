@@ -49,17 +49,9 @@
 #include "route.h"
 #include "system.h"
 #include "text.h"
+#include "til.h"
 #include "world.h"
 
-namespace
-{
-    bool SortPlayers( const Player * player1, const Player * player2 )
-    {
-        return ( player1->isControlHuman() && !player2->isControlHuman() )
-               || ( ( player1->isControlHuman() == player2->isControlHuman() ) && ( player1->GetColor() < player2->GetColor() ) );
-    }
-}
-
 int Game::StartBattleOnly( void )
 {
     Battle::Only main;
@@ -84,6 +76,9 @@ int Game::StartGame( void )
     cursor.Hide();
     AGG::ResetMixer();
 
+    // Ground tiles are decoded while the interface is being reset.
+    fheroes2::AGG::Prefetch( std::vector<int>(), {TIL::GROUND32, TIL::CLOF32, TIL::STON} );
+
     Interface::Basic::Get().Reset();
 
     return Interface::Basic::Get().StartGame();
@@ -527,8 +522,7 @@ int Interface::Basic::StartGame( void )
     GameOver::Result & gameResult = GameOver::Result::Get();
     int res = Game::ENDTURN;
 
-    std::vector<Player *> sortedPlayers = conf.GetPlayers();
-    std::sort( sortedPlayers.begin(), sortedPlayers.end(), SortPlayers );
+    const std::vector<Player *> sortedPlayers = conf.GetPlayers().getInTurnOrder();
 
     while ( res == Game::ENDTURN ) {
         if ( !skip_turns )
@@ -696,6 +690,9 @@ int Interface::Basic::HumanTurn( bool isload )
 
     // startgame loop
     while ( Game::CANCEL == res ) {
+        // Nothing holds cached sprites between frames so here is the right moment to release them.
+        AGG::ReleaseUnusedResources();
+
         if ( !le.HandleEvents( true, true ) ) {
             if ( EventExit() == Game::QUITGAME ) {
                 res = Game::QUITGAME;
@@ -1040,10 +1037,20 @@ int Interface::Basic::HumanTurn( bool isload )
         }
 
         if ( NeedRedraw() ) {
+            // map animation changes only the game area so the rest of the interface doesn't need to be rendered
+            const bool isGameAreaOnly = ( GetRedrawMask() == REDRAW_GAMEAREA ) && !conf.ExtGameHideInterface();
+
             cursor.Hide();
             Redraw();
             cursor.Show();
-            display.render();
+
+            if ( isGameAreaOnly ) {
+                const Rect & gameAreaRoi = gameArea.GetROI();
+                display.render( fheroes2::Rect( gameAreaRoi.x, gameAreaRoi.y, gameAreaRoi.w, gameAreaRoi.h ) );
+            }
+            else {
+                display.render();
+            }
         }
         else if ( !cursor.isVisible() ) {
             cursor.Show();
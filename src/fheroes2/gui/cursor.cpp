@@ -84,7 +84,8 @@ void Cursor::Redraw( s32 x, s32 y )
     if ( fheroes2::cursor().isSoftwareEmulation() ) {
         Cursor::Get().Move( x, y );
         if ( fheroes2::cursor().isVisible() ) {
-            fheroes2::Display::instance().render();
+            // Only the cursor has been moved so render the areas of its previous and new positions.
+            fheroes2::Display::instance().render( fheroes2::Rect( x, y, 1, 1 ) );
         }
     }
 }
@@ -29,11 +29,48 @@
 #include "logging.h"
 #include "maps.h"
 #include "pal.h"
+#include "render_profiler.h"
 #include "route.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
 
+namespace
+{
+    const int32_t groundChunkSize = 8; // in tiles
+
+    // Invisible chunks are removed from the cache only when it grows above this limit.
+    const size_t groundChunkLimit = 128;
+
+    const uint32_t emptyGroundSprite = 0xFFFFFFFF;
+
+    // Sprites of objects, monsters, boats and heroes can cover neighbouring tiles. When only a part of the area is drawn,
+    // tiles this far around it are drawn as well, clipped by the draw ROI.
+    const int32_t partialRedrawTileMargin = 2;
+
+    int32_t GetGroundChunkId( const int32_t tileId )
+    {
+        return tileId >= 0 ? tileId / groundChunkSize : ( tileId + 1 ) / groundChunkSize - 1;
+    }
+
+    int32_t GetTileId( const int32_t pixel )
+    {
+        return pixel >= 0 ? pixel / TILEWIDTH : ( pixel + 1 ) / TILEWIDTH - 1;
+    }
+
+    uint32_t GetGroundSprite( const int32_t x, const int32_t y )
+    {
+        if ( x < 0 || y < 0 || x >= world.w() || y >= world.h() ) {
+            // Tiles outside of World Map depend only on their position.
+            return emptyGroundSprite;
+        }
+
+        const Maps::Tiles & tile = world.GetTiles( x, y );
+        return ( tile.TileSpriteShape() << 16 ) | tile.TileSpriteIndex();
+    }
+}
+
 Interface::GameArea::GameArea( Basic & basic )
     : interface( basic )
     , _minLeftOffset( 0 )
@@ -43,6 +80,9 @@ Interface::GameArea::GameArea( Basic & basic )
     , _prevIndexPos( 0 )
     , scrollDirection( 0 )
     , updateCursor( false )
+    , _isScrolled( false )
+    , _isDisplayFrameValid( false )
+    , _displayFrameAnimationId( 0 )
 {}
 
 Rect Interface::GameArea::GetVisibleTileROI( void ) const
@@ -57,7 +97,7 @@ void Interface::GameArea::ShiftCenter( const Point & offset )
 
 Rect Interface::GameArea::RectFixed( Point & dst, int rw, int rh ) const
 {
-    std::pair<Rect, Point> res = Rect::Fixed4Blit( Rect( dst.x, dst.y, rw, rh ), GetROI() );
+    std::pair<Rect, Point> res = Rect::Fixed4Blit( Rect( dst.x, dst.y, rw, rh ), _drawROI );
     dst = res.second;
     return res.first;
 }
@@ -75,6 +115,8 @@ void Interface::GameArea::Build( void )
 void Interface::GameArea::SetAreaPosition( s32 x, s32 y, u32 w, u32 h )
 {
     _windowROI = Rect( x, y, w, h );
+    _drawROI = _windowROI;
+    _isDisplayFrameValid = false;
     const Size worldSize = Size( world.w() * TILEWIDTH, world.h() * TILEWIDTH );
 
     if ( worldSize.w > w ) {
@@ -114,10 +156,10 @@ void Interface::GameArea::BlitOnTile( fheroes2::Image & dst, const fheroes2::Ima
     const int32_t height = src.height();
 
     // In most of cases objects locate within window ROI so we don't need to calculate truncated ROI
-    if ( dstpt.x >= _windowROI.x && dstpt.y >= _windowROI.y && dstpt.x + width <= _windowROI.x + _windowROI.w && dstpt.y + height <= _windowROI.y + _windowROI.h ) {
+    if ( dstpt.x >= _drawROI.x && dstpt.y >= _drawROI.y && dstpt.x + width <= _drawROI.x + _drawROI.w && dstpt.y + height <= _drawROI.y + _drawROI.h ) {
         fheroes2::AlphaBlit( src, 0, 0, dst, dstpt.x, dstpt.y, width, height, alpha, flip );
     }
-    else if ( _windowROI & Rect( dstpt, width, height ) ) {
+    else if ( _drawROI & Rect( dstpt, width, height ) ) {
         const Rect & fixedRect = RectFixed( dstpt, width, height );
         fheroes2::AlphaBlit( src, fixedRect.x, fixedRect.y, dst, dstpt.x, dstpt.y, fixedRect.w, fixedRect.h, alpha, flip );
     }
@@ -131,45 +173,188 @@ void Interface::GameArea::DrawTile( fheroes2::Image & dst, const fheroes2::Image
     const int32_t height = src.height();
 
     // In most of cases objects locate within window ROI so we don't need to calculate truncated ROI
-    if ( dstpt.x >= _windowROI.x && dstpt.y >= _windowROI.y && dstpt.x + width <= _windowROI.x + _windowROI.w && dstpt.y + height <= _windowROI.y + _windowROI.h ) {
+    if ( dstpt.x >= _drawROI.x && dstpt.y >= _drawROI.y && dstpt.x + width <= _drawROI.x + _drawROI.w && dstpt.y + height <= _drawROI.y + _drawROI.h ) {
         fheroes2::Copy( src, 0, 0, dst, dstpt.x, dstpt.y, width, height );
     }
-    else if ( _windowROI & Rect( dstpt, width, height ) ) {
+    else if ( _drawROI & Rect( dstpt, width, height ) ) {
         const Rect & fixedRect = RectFixed( dstpt, width, height );
         fheroes2::Copy( src, fixedRect.x, fixedRect.y, dst, dstpt.x, dstpt.y, fixedRect.w, fixedRect.h );
     }
 }
 
-void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw ) const
+void Interface::GameArea::_updateGroundChunk( GroundChunk & chunk, const Point & firstTile ) const
 {
-    const Rect tileROI = GetVisibleTileROI();
-
-    int32_t minX = tileROI.x;
-    int32_t minY = tileROI.y;
-    int32_t maxX = tileROI.x + tileROI.w;
-    int32_t maxY = tileROI.y + tileROI.h;
+    const bool isNewChunk = chunk.image.empty();
+    if ( isNewChunk ) {
+        chunk.image.resize( groundChunkSize * TILEWIDTH, groundChunkSize * TILEWIDTH );
+        chunk.tileSprites.assign( groundChunkSize * groundChunkSize, emptyGroundSprite );
+    }
 
-    // Ground level. Also find range of X and Y tile positions.
-    for ( int32_t y = 0; y < tileROI.h; ++y ) {
-        Point offset( tileROI.x, tileROI.y + y );
+    // Only tiles which have been changed since the last update are drawn again.
+    for ( int32_t y = 0; y < groundChunkSize; ++y ) {
+        for ( int32_t x = 0; x < groundChunkSize; ++x ) {
+            const Point mp( firstTile.x + x, firstTile.y + y );
+            const uint32_t sprite = GetGroundSprite( mp.x, mp.y );
 
-        if ( offset.y < 0 || offset.y >= world.h() ) {
-            for ( ; offset.x < maxX; ++offset.x ) {
-                Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI );
+            uint32_t & cachedSprite = chunk.tileSprites[y * groundChunkSize + x];
+            if ( !isNewChunk && cachedSprite == sprite ) {
+                continue;
             }
+
+            cachedSprite = sprite;
+
+            const fheroes2::Image & tileImage = ( sprite == emptyGroundSprite ) ? Maps::Tiles::GetEmptyTileSurface( mp ) : world.GetTiles( mp.x, mp.y ).GetTileSurface();
+            fheroes2::Copy( tileImage, 0, 0, chunk.image, x * TILEWIDTH, y * TILEWIDTH, tileImage.width(), tileImage.height() );
         }
-        else {
-            for ( ; offset.x < maxX; ++offset.x ) {
-                if ( offset.x < 0 || offset.x >= world.w() ) {
-                    Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI );
-                }
-                else {
-                    world.GetTiles( offset.x, offset.y ).RedrawTile( dst, tileROI, *this );
-                }
+    }
+}
+
+void Interface::GameArea::_redrawGround( fheroes2::Image & dst, const Rect & tileROI ) const
+{
+    RENDER_PROFILE( MAP_BOTTOM );
+
+    const Size worldSize( world.w(), world.h() );
+    if ( _groundChunksWorldSize != worldSize ) {
+        _groundChunks.clear();
+        _groundChunksWorldSize = worldSize;
+    }
+
+    const int32_t chunkWidth = groundChunkSize * TILEWIDTH;
+
+    const int32_t drawMaxX = _drawROI.x + _drawROI.w;
+    const int32_t drawMaxY = _drawROI.y + _drawROI.h;
+
+    const int32_t minChunkX = GetGroundChunkId( tileROI.x );
+    const int32_t minChunkY = GetGroundChunkId( tileROI.y );
+    const int32_t maxChunkX = GetGroundChunkId( tileROI.x + tileROI.w - 1 );
+    const int32_t maxChunkY = GetGroundChunkId( tileROI.y + tileROI.h - 1 );
+
+    for ( int32_t chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY ) {
+        for ( int32_t chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX ) {
+            const Point firstTile( chunkX * groundChunkSize, chunkY * groundChunkSize );
+
+            GroundChunk & chunk = _groundChunks[std::make_pair( chunkX, chunkY )];
+            _updateGroundChunk( chunk, firstTile );
+
+            // Truncate the chunk by draw ROI.
+            const Point chunkPos = GetRelativeTilePosition( firstTile );
+            const int32_t minX = std::max<int32_t>( chunkPos.x, _drawROI.x );
+            const int32_t minY = std::max<int32_t>( chunkPos.y, _drawROI.y );
+            const int32_t maxX = std::min<int32_t>( chunkPos.x + chunkWidth, drawMaxX );
+            const int32_t maxY = std::min<int32_t>( chunkPos.y + chunkWidth, drawMaxY );
+
+            if ( minX < maxX && minY < maxY ) {
+                fheroes2::Copy( chunk.image, minX - chunkPos.x, minY - chunkPos.y, dst, minX, minY, maxX - minX, maxY - minY );
             }
         }
     }
 
+    if ( _groundChunks.size() > groundChunkLimit ) {
+        // A part of the area could be drawn so chunks are kept by the whole visible area, not by the drawn one.
+        const Rect visibleTileROI = GetVisibleTileROI();
+        const int32_t minVisibleChunkX = GetGroundChunkId( visibleTileROI.x );
+        const int32_t minVisibleChunkY = GetGroundChunkId( visibleTileROI.y );
+        const int32_t maxVisibleChunkX = GetGroundChunkId( visibleTileROI.x + visibleTileROI.w - 1 );
+        const int32_t maxVisibleChunkY = GetGroundChunkId( visibleTileROI.y + visibleTileROI.h - 1 );
+
+        for ( std::map<std::pair<int32_t, int32_t>, GroundChunk>::iterator it = _groundChunks.begin(); it != _groundChunks.end(); ) {
+            const int32_t chunkX = it->first.first;
+            const int32_t chunkY = it->first.second;
+            if ( chunkX < minVisibleChunkX || chunkX > maxVisibleChunkX || chunkY < minVisibleChunkY || chunkY > maxVisibleChunkY )
+                it = _groundChunks.erase( it );
+            else
+                ++it;
+        }
+    }
+}
+
+void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw ) const
+{
+    const bool isScrolled = _isScrolled;
+    _isScrolled = false;
+
+    if ( &dst != &fheroes2::Display::instance() ) {
+        _redraw( dst, flag, isPuzzleDraw );
+        return;
+    }
+
+    if ( flag != LEVEL_ALL || isPuzzleDraw ) {
+        _isDisplayFrameValid = false;
+        _redraw( dst, flag, isPuzzleDraw );
+        return;
+    }
+
+    // The previous frame can be moved on the display only if nothing but the area position has been changed since it was drawn.
+    // Interface elements drawn over the area in hidden interface mode would be moved as well.
+    const Point shift = _displayFrameOffset - _topLeftTileOffset;
+    if ( isScrolled && _isDisplayFrameValid && _displayFrameAnimationId == Game::MapsAnimationFrame() && !Settings::Get().ExtGameHideInterface()
+         && std::abs( static_cast<int32_t>( shift.x ) ) < _windowROI.w && std::abs( static_cast<int32_t>( shift.y ) ) < _windowROI.h ) {
+        _redrawShifted( dst, shift );
+    }
+    else {
+        _redraw( dst, flag, isPuzzleDraw );
+    }
+
+    _isDisplayFrameValid = true;
+    _displayFrameOffset = _topLeftTileOffset;
+    _displayFrameAnimationId = Game::MapsAnimationFrame();
+}
+
+void Interface::GameArea::_redrawShifted( fheroes2::Image & dst, const Point & shift ) const
+{
+    if ( shift.x == 0 && shift.y == 0 ) {
+        return;
+    }
+
+    fheroes2::Shift( dst, _windowROI.x, _windowROI.y, _windowROI.w, _windowROI.h, shift.x, shift.y );
+
+    // Draw only uncovered parts of the area.
+    const int32_t shiftWidth = std::abs( static_cast<int32_t>( shift.x ) );
+    const int32_t shiftHeight = std::abs( static_cast<int32_t>( shift.y ) );
+
+    if ( shiftWidth > 0 ) {
+        const int32_t offsetX = shift.x > 0 ? _windowROI.x : _windowROI.x + _windowROI.w - shiftWidth;
+        _drawROI = Rect( offsetX, _windowROI.y, shiftWidth, _windowROI.h );
+        _redraw( dst, LEVEL_ALL, false, _getDrawTileROI() );
+    }
+
+    if ( shiftHeight > 0 ) {
+        const int32_t offsetX = shift.x > 0 ? _windowROI.x + shiftWidth : _windowROI.x;
+        const int32_t offsetY = shift.y > 0 ? _windowROI.y : _windowROI.y + _windowROI.h - shiftHeight;
+        _drawROI = Rect( offsetX, offsetY, _windowROI.w - shiftWidth, shiftHeight );
+        _redraw( dst, LEVEL_ALL, false, _getDrawTileROI() );
+    }
+
+    _drawROI = _windowROI;
+}
+
+Rect Interface::GameArea::_getDrawTileROI() const
+{
+    const Point offset = _topLeftTileOffset - Point( _windowROI.x, _windowROI.y );
+
+    const int32_t minX = GetTileId( offset.x + _drawROI.x ) - partialRedrawTileMargin;
+    const int32_t minY = GetTileId( offset.y + _drawROI.y ) - partialRedrawTileMargin;
+    const int32_t maxX = GetTileId( offset.x + _drawROI.x + _drawROI.w - 1 ) + partialRedrawTileMargin;
+    const int32_t maxY = GetTileId( offset.y + _drawROI.y + _drawROI.h - 1 ) + partialRedrawTileMargin;
+
+    return Rect::Get( Rect( minX, minY, maxX - minX + 1, maxY - minY + 1 ), GetVisibleTileROI(), true );
+}
+
+void Interface::GameArea::_redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw ) const
+{
+    _redraw( dst, flag, isPuzzleDraw, GetVisibleTileROI() );
+}
+
+void Interface::GameArea::_redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw, const Rect & tileROI ) const
+{
+    int32_t minX = tileROI.x;
+    int32_t minY = tileROI.y;
+    int32_t maxX = tileROI.x + tileROI.w;
+    int32_t maxY = tileROI.y + tileROI.h;
+
+    // Ground level.
+    _redrawGround( dst, tileROI );
+
     if ( minX < 0 )
         minX = 0;
     if ( minY < 0 )
@@ -180,14 +365,16 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
         maxY = world.h();
 
     if ( minX >= maxX || minY >= maxY ) {
-        // This can't be true! Please check your code changes as we shouldn't have an empty area.
-        assert( 0 );
+        // Only a part of the area can be entirely outside of World Map. This can't be true for the whole area!
+        assert( tileROI.w < _visibleTileCount.w || tileROI.h < _visibleTileCount.h );
         return;
     }
 
     // Bottom layer and objects.
     const bool drawBottom = ( flag & LEVEL_BOTTOM ) == LEVEL_BOTTOM;
     if ( drawBottom ) {
+        RENDER_PROFILE( MAP_BOTTOM );
+
         for ( int32_t y = minY; y < maxY; ++y ) {
             for ( int32_t x = minX; x < maxX; ++x ) {
                 const Maps::Tiles & tile = world.GetTiles( x, y );
@@ -217,6 +404,8 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     // Monsters and boats.
     const bool drawMonstersAndBoats = ( flag & LEVEL_OBJECTS ) && !isPuzzleDraw;
     if ( drawMonstersAndBoats ) {
+        RENDER_PROFILE( MAP_OBJECTS );
+
         for ( int32_t y = minY; y < maxY; ++y ) {
             for ( int32_t x = minX; x < maxX; ++x ) {
                 world.GetTiles( x, y ).RedrawMonstersAndBoat( dst, tileROI, true, *this );
@@ -241,26 +430,34 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     const bool drawHeroes = ( flag & LEVEL_HEROES ) == LEVEL_HEROES;
     std::vector<std::pair<Point, const Heroes *> > heroList;
 
-    for ( int32_t y = minY; y < maxY; ++y ) {
-        for ( int32_t x = minX; x < maxX; ++x ) {
-            const Maps::Tiles & tile = world.GetTiles( x, y );
+    {
+        RENDER_PROFILE( MAP_TOP );
 
-            // top
-            if ( drawTop )
-                tile.RedrawTop( dst, tileROI, *this );
+        for ( int32_t y = minY; y < maxY; ++y ) {
+            for ( int32_t x = minX; x < maxX; ++x ) {
+                const Maps::Tiles & tile = world.GetTiles( x, y );
 
-            // heroes will be drawn later
-            if ( tile.GetObject() == MP2::OBJ_HEROES && drawHeroes ) {
-                const Heroes * hero = tile.GetHeroes();
-                if ( hero ) {
-                    heroList.emplace_back( GetRelativeTilePosition( Point( x, y ) ), hero );
+                // top
+                if ( drawTop )
+                    tile.RedrawTop( dst, tileROI, *this );
+
+                // heroes will be drawn later
+                if ( tile.GetObject() == MP2::OBJ_HEROES && drawHeroes ) {
+                    const Heroes * hero = tile.GetHeroes();
+                    if ( hero ) {
+                        heroList.emplace_back( GetRelativeTilePosition( Point( x, y ) ), hero );
+                    }
                 }
             }
         }
     }
 
-    for ( const std::pair<Point, const Heroes *> & hero : heroList ) {
-        hero.second->Redraw( dst, hero.first.x, hero.first.y - 1, tileROI, true, *this );
+    {
+        RENDER_PROFILE( MAP_HEROES );
+
+        for ( const std::pair<Point, const Heroes *> & hero : heroList ) {
+            hero.second->Redraw( dst, hero.first.x, hero.first.y - 1, tileROI, true, *this );
+        }
     }
 
     // Route
@@ -268,6 +465,8 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     const bool drawRoutes = ( flag & LEVEL_ROUTES ) != 0;
 
     if ( hero && hero->GetPath().isShow() && drawRoutes ) {
+        RENDER_PROFILE( MAP_ROUTES );
+
         const Route::Path & path = hero->GetPath();
         int green = path.GetAllowedSteps();
 
@@ -320,6 +519,8 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
 #endif
         // redraw fog
         if ( flag & LEVEL_FOG ) {
+        RENDER_PROFILE( MAP_FOG );
+
         const int colors = Players::FriendColors();
 
         for ( int32_t y = minY; y < maxY; ++y ) {
@@ -353,6 +554,7 @@ void Interface::GameArea::Scroll( void )
     }
 
     ShiftCenter( offset );
+    _isScrolled = true;
 
     scrollDirection = 0;
 }
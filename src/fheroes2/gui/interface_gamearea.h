@@ -27,6 +27,9 @@
 #include "image.h"
 #include "timing.h"
 
+#include <map>
+#include <vector>
+
 namespace Interface
 {
     class Basic;
@@ -118,6 +121,7 @@ namespace Interface
         Basic & interface;
 
         Rect _windowROI; // visible to draw area of World Map in pixels
+        mutable Rect _drawROI; // part of window ROI which is being drawn at the moment
         Point _topLeftTileOffset; // offset of tiles to be drawn (from here we can find any tile ID)
 
         // boundaries for World Map
@@ -134,8 +138,37 @@ namespace Interface
 
         fheroes2::Time scrollTime;
 
+        // State of the last frame drawn on the display. It is used to move the frame while scrolling instead of drawing it again.
+        mutable bool _isScrolled;
+        mutable bool _isDisplayFrameValid;
+        mutable Point _displayFrameOffset;
+        mutable uint32_t _displayFrameAnimationId;
+
+        // Pre-rendered ground of square blocks of tiles. It is used instead of drawing every TIL image on each redraw.
+        struct GroundChunk
+        {
+            GroundChunk()
+            {
+                // ground tiles are opaque so only the image layer has to be copied
+                image._disableTransformLayer();
+            }
+
+            fheroes2::Image image;
+            std::vector<uint32_t> tileSprites; // sprite index and shape of every tile which is drawn on the image
+        };
+
+        mutable std::map<std::pair<int32_t, int32_t>, GroundChunk> _groundChunks;
+        mutable Size _groundChunksWorldSize;
+
+        void _redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw ) const;
+        void _redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw, const Rect & tileROI ) const; // draws only tiles within tileROI
+        void _redrawShifted( fheroes2::Image & dst, const Point & shift ) const;
+        void _redrawGround( fheroes2::Image & dst, const Rect & tileROI ) const;
+        void _updateGroundChunk( GroundChunk & chunk, const Point & firstTile ) const;
+
         Point _middlePoint() const; // returns middle point of window ROI
         Point _getStartTileId() const;
+        Rect _getDrawTileROI() const; // returns visible tiles which can be drawn within draw ROI
         void _setCenterToTile( const Point & tile ); // set center to the middle of tile (input is tile ID)
     };
 }
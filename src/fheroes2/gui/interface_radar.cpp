@@ -30,6 +30,7 @@
 #include "ground.h"
 #include "interface_radar.h"
 #include "logging.h"
+#include "render_profiler.h"
 #include "text.h"
 #include "world.h"
 
@@ -219,6 +220,8 @@ void Interface::Radar::SetRedraw( void ) const
 
 void Interface::Radar::Redraw()
 {
+    RENDER_PROFILE( RADAR );
+
     const Settings & conf = Settings::Get();
     const bool hideInterface = conf.ExtGameHideInterface();
 
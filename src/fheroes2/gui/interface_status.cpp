@@ -464,6 +464,9 @@ void Interface::StatusWindow::RedrawTurnProgress( u32 v )
     turn_progress = v;
     SetRedraw();
 
+    if ( Settings::Get().Headless() )
+        return;
+
     Cursor::Get().Hide();
     interface.Redraw();
     Cursor::Get().Show();
@@ -20,10 +20,13 @@
 
 #include "ui_tool.h"
 #include "localevent.h"
+#include "render_profiler.h"
 #include "screen.h"
 #include "settings.h"
 #include "text.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstring>
 #include <ctime>
@@ -39,10 +42,10 @@ namespace
             : _startTime( std::chrono::high_resolution_clock::now() )
         {}
 
-        void preRender()
+        fheroes2::Rect preRender()
         {
             if ( !Settings::Get().ExtGameShowSystemInfo() )
-                return;
+                return fheroes2::Rect();
 
             const int32_t offsetX = 26;
             const int32_t offsetY = fheroes2::Display::instance().height() - 30;
@@ -81,10 +84,49 @@ namespace
             _text.SetPos( offsetX, offsetY );
             _text.SetText( info );
             _text.Show();
+
+            fheroes2::Rect drawnRoi = _text.GetRect();
+
+#ifdef WITH_RENDER_PROFILING
+            // Average time of every render stage is shown above FPS line.
+            int32_t stageOffsetY = offsetY;
+            for ( int stage = fheroes2::RenderProfiler::STAGE_COUNT - 1; stage >= 0; --stage ) {
+                const int32_t timeUs = static_cast<int32_t>( fheroes2::RenderProfiler::GetAverageTime( stage ) * 1000 );
+
+                std::string stageInfo( fheroes2::RenderProfiler::GetStageName( stage ) );
+                stageInfo += ": ";
+                stageInfo += std::to_string( timeUs / 1000 );
+                stageInfo += ".";
+                const int32_t fraction = timeUs % 1000;
+                stageInfo += fraction < 100 ? ( fraction < 10 ? "00" : "0" ) : "";
+                stageInfo += std::to_string( fraction );
+                stageInfo += " ms";
+
+                TextSprite & stageText = _stageText[stage];
+                stageText.SetText( stageInfo );
+                stageOffsetY -= stageText.h();
+                stageText.SetPos( offsetX, stageOffsetY );
+                stageText.Show();
+
+                const fheroes2::Rect stageRoi = stageText.GetRect();
+                drawnRoi.y = stageRoi.y;
+                drawnRoi.width = std::max( drawnRoi.width, stageRoi.width );
+                drawnRoi.height += stageRoi.height;
+            }
+#endif
+
+            return drawnRoi;
         }
 
         void postRender()
         {
+#ifdef WITH_RENDER_PROFILING
+            for ( TextSprite & stageText : _stageText ) {
+                if ( stageText.isShow() )
+                    stageText.Hide();
+            }
+#endif
+
             if ( _text.isShow() )
                 _text.Hide();
         }
@@ -93,6 +135,9 @@ namespace
         std::chrono::time_point<std::chrono::high_resolution_clock> _startTime;
         TextSprite _text;
         std::deque<double> _fps;
+#ifdef WITH_RENDER_PROFILING
+        std::array<TextSprite, fheroes2::RenderProfiler::STAGE_COUNT> _stageText;
+#endif
     };
 
     SystemInfoRenderer systemInfoRenderer;
@@ -355,9 +400,9 @@ namespace fheroes2
         }
     }
 
-    void PreRenderSystemInfo()
+    Rect PreRenderSystemInfo()
     {
-        systemInfoRenderer.preRender();
+        return systemInfoRenderer.preRender();
     }
 
     void PostRenderSystemInfo()
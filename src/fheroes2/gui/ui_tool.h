@@ -72,8 +72,8 @@ namespace fheroes2
     void InvertedFadeWithPalette( const Image & top, const Point & offset, const Image & middle, const Point & middleOffset, uint8_t paletteId, int delayMs,
                                   int frameCount );
 
-    // Display pre-render function to show screen system info
-    void PreRenderSystemInfo();
+    // Display pre-render function to show screen system info. Returns the area of the shown info
+    Rect PreRenderSystemInfo();
 
     // Display post-render function to hide screen system info
     void PostRenderSystemInfo();
@@ -94,7 +94,7 @@ bool ReflectSprite( int from )
     return false;
 }
 
-fheroes2::Sprite SpriteHero( const Heroes & hero, int index, bool rotate )
+const fheroes2::Sprite & SpriteHero( const Heroes & hero, int index, bool rotate )
 {
     int icn_hero = ICN::UNKNOWN;
     int index_sprite = 0;
@@ -164,7 +164,7 @@ fheroes2::Sprite SpriteHero( const Heroes & hero, int index, bool rotate )
     return fheroes2::AGG::GetICN( icn_hero, index_sprite + ( index % 9 ) );
 }
 
-fheroes2::Sprite SpriteFlag( const Heroes & hero, int index, bool rotate )
+const fheroes2::Sprite & SpriteFlag( const Heroes & hero, int index, bool rotate, Point & offset )
 {
     int icn_flag = ICN::UNKNOWN;
     int index_sprite = 0;
@@ -229,7 +229,7 @@ fheroes2::Sprite SpriteFlag( const Heroes & hero, int index, bool rotate )
         }
 
     const int frameId = index % heroFrameCount;
-    fheroes2::Sprite flag = fheroes2::AGG::GetICN( icn_flag, index_sprite + frameId );
+    offset = Point();
     if ( !hero.isMoveEnabled() ) {
         static const Point offsetTop[heroFrameCount]
             = {Point( 0, 0 ), Point( 0, 2 ), Point( 0, 3 ), Point( 0, 2 ), Point( 0, 0 ), Point( 0, 1 ), Point( 0, 3 ), Point( 0, 2 ), Point( 0, 1 )};
@@ -251,7 +251,6 @@ fheroes2::Sprite SpriteFlag( const Heroes & hero, int index, bool rotate )
         static const Point offsetShipBottomSideways[heroFrameCount]
             = {Point( 0, -2 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 ), Point( 0, 0 )};
 
-        Point offset;
         switch ( hero.GetDirection() ) {
         case Direction::TOP:
             offset = hero.isShipMaster() ? offsetShipTopBottom[frameId] : offsetTop[frameId];
@@ -272,13 +271,11 @@ fheroes2::Sprite SpriteFlag( const Heroes & hero, int index, bool rotate )
             offset = hero.isShipMaster() ? offsetShipBottomSideways[frameId] : offsetBottomSideways[frameId];
             break;
         }
-
-        flag.setPosition( flag.x() + offset.x, flag.y() + offset.y );
     }
-    return flag;
+    return fheroes2::AGG::GetICN( icn_flag, index_sprite + frameId );
 }
 
-fheroes2::Sprite SpriteShad( const Heroes & hero, int index )
+const fheroes2::Sprite & SpriteShad( const Heroes & hero, int index )
 {
     if ( hero.isShipMaster() ) {
         int indexSprite = 0;
@@ -335,7 +332,7 @@ fheroes2::Sprite SpriteShad( const Heroes & hero, int index )
     }
 }
 
-fheroes2::Sprite SpriteFroth( const Heroes & hero, int index )
+const fheroes2::Sprite & SpriteFroth( const Heroes & hero, int index )
 {
     int index_sprite = 0;
 
@@ -411,12 +408,13 @@ void Heroes::Redraw( fheroes2::Image & dst, int32_t dx, int32_t dy, const Rect &
         dy -= 10;
 
     const fheroes2::Sprite & sprite1 = SpriteHero( *this, sprite_index, false );
-    const fheroes2::Sprite & sprite2 = SpriteFlag( *this, flagFrameID, false );
+    Point flagOffset;
+    const fheroes2::Sprite & sprite2 = SpriteFlag( *this, flagFrameID, false, flagOffset );
     const fheroes2::Sprite & sprite3 = SpriteShad( *this, sprite_index );
     const fheroes2::Sprite & sprite4 = SpriteFroth( *this, sprite_index );
 
     Point dst_pt1( dx + ( reflect ? TILEWIDTH - sprite1.x() - sprite1.width() : sprite1.x() ), dy + sprite1.y() + TILEWIDTH );
-    Point dst_pt2( dx + ( reflect ? TILEWIDTH - sprite2.x() - sprite2.width() : sprite2.x() ), dy + sprite2.y() + TILEWIDTH );
+    Point dst_pt2( dx + ( reflect ? TILEWIDTH - sprite2.x() - flagOffset.x - sprite2.width() : sprite2.x() + flagOffset.x ), dy + sprite2.y() + flagOffset.y + TILEWIDTH );
     Point dst_pt3( dx + sprite3.x(), dy + sprite3.y() + TILEWIDTH );
     Point dst_pt4( dx + ( reflect ? TILEWIDTH - sprite4.x() - sprite4.width() : sprite4.x() ), dy + sprite4.y() + TILEWIDTH );
 
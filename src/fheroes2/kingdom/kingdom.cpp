@@ -375,9 +375,14 @@ void Kingdom::SetVisited( s32 index, int object )
         visit_object.push_front( IndexObject( index, object ) );
 }
 
+bool Kingdom::isKingdomObjectType( int objectID )
+{
+    return MP2::isGroundObject( objectID ) || objectID == MP2::OBJ_COAST;
+}
+
 bool Kingdom::isValidKingdomObject( const Maps::Tiles & tile, int objectID ) const
 {
-    if ( !MP2::isGroundObject( objectID ) && objectID != MP2::OBJ_COAST )
+    if ( !isKingdomObjectType( objectID ) )
         return false;
 
     if ( isVisited( tile.GetIndex(), objectID ) )
@@ -174,6 +174,9 @@ public:
     static u32 GetMaxHeroes( void );
     static cost_t GetKingdomStartingResources( int difficulty, bool isAIKingdom );
 
+    // Returns false for object types which are never valid kingdom objects. It's a cheap pre-check of isValidKingdomObject.
+    static bool isKingdomObjectType( int objectID );
+
 private:
     friend StreamBase & operator<<( StreamBase &, const Kingdom & );
     friend StreamBase & operator>>( StreamBase &, Kingdom & );
@@ -31,6 +31,8 @@
 #include "world.h"
 
 #include <cassert>
+#include <iterator>
+#include <vector>
 
 //#define VIEWWORLD_DEBUG_ZOOM_LEVEL  // Activate this when you want to debug this window. It will provide an extra zoom level at 1:1 scale
 
@@ -412,6 +414,11 @@ void ViewWorld::ViewWorldWindow( const int color, const ViewWorldMode mode, Inte
 
     fheroes2::ImageRestorer restorer( display );
 
+    // Icons of all zoom levels are decoded while the world map is being rendered.
+    std::vector<int> icnIds( std::begin( icnPerZoomLevel ), std::end( icnPerZoomLevel ) );
+    icnIds.insert( icnIds.end(), std::begin( icnPerZoomLevelFlags ), std::end( icnPerZoomLevelFlags ) );
+    fheroes2::AGG::Prefetch( icnIds );
+
     LocalEvent & le = LocalEvent::Get();
     le.PauseCycling();
 
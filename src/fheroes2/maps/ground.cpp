@@ -55,6 +55,11 @@ const char * Maps::Ground::String( int ground )
 }
 
 uint32_t Maps::Ground::GetPenalty( const Maps::Tiles & tile, uint32_t level )
+{
+    return GetPenalty( tile.GetGround(), level );
+}
+
+uint32_t Maps::Ground::GetPenalty( int ground, uint32_t level )
 {
     //            none   basc   advd   expr
     //    Desert  2.00   1.75   1.50   1.00
@@ -69,7 +74,7 @@ uint32_t Maps::Ground::GetPenalty( const Maps::Tiles & tile, uint32_t level )
     //    Road    0.75   0.75   0.75   0.75
 
     uint32_t result = defaultGroundPenalty;
-    switch ( tile.GetGround() ) {
+    switch ( ground ) {
     case DESERT:
         switch ( level ) {
         case Skill::Level::EXPERT:
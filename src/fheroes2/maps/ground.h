@@ -52,6 +52,7 @@ namespace Maps
 
         const char * String( int );
         uint32_t GetPenalty( const Maps::Tiles & tile, uint32_t pathfinding );
+        uint32_t GetPenalty( int ground, uint32_t pathfinding );
     }
 }
 
@@ -410,21 +410,21 @@ Maps::Indexes Maps::GetObjectsPositions( const std::vector<u8> & objs )
 bool MapsTileIsUnderProtection( s32 from, s32 index ) /* from: center, index: monster */
 {
     bool result = false;
-    const Maps::Tiles & tile1 = world.GetTiles( from );
-    const Maps::Tiles & tile2 = world.GetTiles( index );
+    const Maps::TileInfo & tile1 = world.getTileInfo( from );
+    const Maps::TileInfo & tile2 = world.getTileInfo( index );
 
-    if ( !MP2::isPickupObject( tile1.GetObject() ) && tile2.GetObject() == MP2::OBJ_MONSTER && tile1.isWater() == tile2.isWater() ) {
+    if ( !MP2::isPickupObject( tile1.object ) && tile2.object == MP2::OBJ_MONSTER && tile1.isWater == tile2.isWater ) {
         const int monsterDirection = Maps::GetDirection( index, from );
         /* if monster can attack to */
-        result = ( tile2.GetPassable() & monsterDirection ) && ( tile1.GetPassable() & Maps::GetDirection( from, index ) );
+        result = ( tile2.passable & monsterDirection ) && ( tile1.passable & Maps::GetDirection( from, index ) );
 
         if ( !result ) {
             /* h2 specific monster attack: BOTTOM_LEFT impassable! */
-            if ( Direction::BOTTOM_LEFT == monsterDirection && ( Direction::LEFT & tile2.GetPassable() ) && ( Direction::TOP & tile1.GetPassable() ) )
+            if ( Direction::BOTTOM_LEFT == monsterDirection && ( Direction::LEFT & tile2.passable ) && ( Direction::TOP & tile1.passable ) )
                 result = true;
             else
                 /* h2 specific monster attack: BOTTOM_RIGHT impassable! */
-                if ( Direction::BOTTOM_RIGHT == monsterDirection && ( Direction::RIGHT & tile2.GetPassable() ) && ( Direction::TOP & tile1.GetPassable() ) )
+                if ( Direction::BOTTOM_RIGHT == monsterDirection && ( Direction::RIGHT & tile2.passable ) && ( Direction::TOP & tile1.passable ) )
                 result = true;
         }
     }
@@ -439,7 +439,7 @@ bool Maps::IsNearTiles( s32 index1, s32 index2 )
 
 bool Maps::TileIsUnderProtection( s32 center )
 {
-    return MP2::OBJ_MONSTER == world.GetTiles( center ).GetObject() ? true : GetTilesUnderProtection( center ).size();
+    return isValidAbsIndex( center ) && world.getTileProtection( center ) != 0;
 }
 
 Maps::Indexes Maps::GetTilesUnderProtection( s32 center )
@@ -448,41 +448,32 @@ Maps::Indexes Maps::GetTilesUnderProtection( s32 center )
     if ( !isValidAbsIndex( center ) )
         return result;
 
-    result.reserve( 9 );
-    const int width = world.w();
-    const int x = center % width;
-    const int y = center / width;
-
-    auto validateAndInsert = [&result, &center]( const int index ) {
-        if ( MapsTileIsUnderProtection( center, index ) )
-            result.push_back( index );
-    };
-
-    if ( y > 0 ) {
-        if ( x > 0 )
-            validateAndInsert( center - width - 1 );
+    const uint16_t protection = world.getTileProtection( center );
+    if ( protection == 0 )
+        return result;
 
-        validateAndInsert( center - width );
+    // keep the order of map rows
+    const int directions[] = {Direction::TOP_LEFT, Direction::TOP,         Direction::TOP_RIGHT, Direction::LEFT,        Direction::CENTER,
+                              Direction::RIGHT,    Direction::BOTTOM_LEFT, Direction::BOTTOM,    Direction::BOTTOM_RIGHT};
 
-        if ( x < width - 1 )
-            validateAndInsert( center - width + 1 );
+    for ( const int direction : directions ) {
+        if ( protection & direction )
+            result.push_back( direction == Direction::CENTER ? center : GetDirectionIndex( center, direction ) );
     }
 
-    if ( x > 0 )
-        validateAndInsert( center - 1 );
-    if ( MP2::OBJ_MONSTER == world.GetTiles( center ).GetObject() )
-        result.push_back( center );
-    if ( x < width - 1 )
-        validateAndInsert( center + 1 );
+    return result;
+}
 
-    if ( y < world.h() - 1 ) {
-        if ( x > 0 )
-            validateAndInsert( center + width - 1 );
+uint16_t Maps::CalculateTileProtection( s32 center )
+{
+    uint16_t result = 0;
 
-        validateAndInsert( center + width );
+    if ( MP2::OBJ_MONSTER == world.getTileInfo( center ).object )
+        result |= Direction::CENTER;
 
-        if ( x < width - 1 )
-            validateAndInsert( center + width + 1 );
+    for ( const int direction : Direction::All() ) {
+        if ( isValidDirection( center, direction ) && MapsTileIsUnderProtection( center, GetDirectionIndex( center, direction ) ) )
+            result |= direction;
     }
 
     return result;
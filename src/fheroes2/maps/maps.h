@@ -70,6 +70,8 @@ namespace Maps
 
     Indexes GetTilesUnderProtection( s32 );
     bool TileIsUnderProtection( s32 );
+    // Directions of the monsters guarding the tile, Direction::CENTER is set if a monster stands on it
+    uint16_t CalculateTileProtection( s32 );
     bool IsNearTiles( s32, s32 );
 
     Indexes GetObjectPositions( int obj, bool ignoreHeroes );
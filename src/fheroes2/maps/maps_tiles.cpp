@@ -63,6 +63,18 @@ namespace
     {
         return ( base & value ) == value;
     }
+
+    bool isValidWaterMove( const bool tileIsWater, const int object, const bool fromWater )
+    {
+        if ( fromWater )
+            return object == MP2::OBJ_COAST || ( tileIsWater && object != MP2::OBJ_BOAT );
+
+        // if we're not in water but tile is; allow movement in three cases
+        if ( tileIsWater )
+            return object == MP2::OBJ_SHIPWRECK || object == MP2::OBJ_HEROES || object == MP2::OBJ_BOAT;
+
+        return true;
+    }
 }
 
 #ifdef WITH_DEBUG
@@ -919,7 +931,8 @@ int Maps::Tiles::GetObject( bool ignoreObjectUnderHero /* true */ ) const
 void Maps::Tiles::SetObject( int object )
 {
     mp2_object = object;
-    world.resetPathfinder();
+    world.updateTileInfo( GetIndex() );
+    world.updatePathfinder( GetIndex() );
 }
 
 void Maps::Tiles::setBoat( int direction )
@@ -1019,6 +1032,24 @@ const fheroes2::Image & Maps::Tiles::GetTileSurface( void ) const
     return fheroes2::AGG::GetTIL( TIL::GROUND32, TileSpriteIndex(), TileSpriteShape() );
 }
 
+const fheroes2::Image & Maps::Tiles::GetEmptyTileSurface( const Point & mp )
+{
+    if ( mp.y == -1 && mp.x >= 0 && mp.x < world.w() ) { // top first row
+        return fheroes2::AGG::GetTIL( TIL::STON, 20 + ( mp.x % 4 ), 0 );
+    }
+    else if ( mp.x == world.w() && mp.y >= 0 && mp.y < world.h() ) { // right first row
+        return fheroes2::AGG::GetTIL( TIL::STON, 24 + ( mp.y % 4 ), 0 );
+    }
+    else if ( mp.y == world.h() && mp.x >= 0 && mp.x < world.w() ) { // bottom first row
+        return fheroes2::AGG::GetTIL( TIL::STON, 28 + ( mp.x % 4 ), 0 );
+    }
+    else if ( mp.x == -1 && mp.y >= 0 && mp.y < world.h() ) { // left first row
+        return fheroes2::AGG::GetTIL( TIL::STON, 32 + ( mp.y % 4 ), 0 );
+    }
+
+    return fheroes2::AGG::GetTIL( TIL::STON, ( std::abs( static_cast<int>( mp.y ) ) % 4 ) * 4 + std::abs( static_cast<int>( mp.x ) ) % 4, 0 );
+}
+
 bool isMountsRocs( const Maps::TilesAddon & ta )
 {
     return Maps::TilesAddon::isMounts( ta ) || Maps::TilesAddon::isRocs( ta );
@@ -1385,39 +1416,6 @@ bool Maps::Tiles::isWater( void ) const
     return 30 > TileSpriteIndex();
 }
 
-void Maps::Tiles::RedrawTile( fheroes2::Image & dst, const Rect & visibleTileROI, const Interface::GameArea & gameArea ) const
-{
-    const Point mp = Maps::GetPoint( GetIndex() );
-
-    if ( visibleTileROI & mp ) {
-        gameArea.DrawTile( dst, GetTileSurface(), mp );
-    }
-}
-
-void Maps::Tiles::RedrawEmptyTile( fheroes2::Image & dst, const Point & mp, const Rect & visibleTileROI )
-{
-    if ( !( visibleTileROI & mp ) ) {
-        return;
-    }
-
-    const Interface::GameArea & area = Interface::Basic::Get().GetGameArea();
-    if ( mp.y == -1 && mp.x >= 0 && mp.x < world.w() ) { // top first row
-        area.DrawTile( dst, fheroes2::AGG::GetTIL( TIL::STON, 20 + ( mp.x % 4 ), 0 ), mp );
-    }
-    else if ( mp.x == world.w() && mp.y >= 0 && mp.y < world.h() ) { // right first row
-        area.DrawTile( dst, fheroes2::AGG::GetTIL( TIL::STON, 24 + ( mp.y % 4 ), 0 ), mp );
-    }
-    else if ( mp.y == world.h() && mp.x >= 0 && mp.x < world.w() ) { // bottom first row
-        area.DrawTile( dst, fheroes2::AGG::GetTIL( TIL::STON, 28 + ( mp.x % 4 ), 0 ), mp );
-    }
-    else if ( mp.x == -1 && mp.y >= 0 && mp.y < world.h() ) { // left first row
-        area.DrawTile( dst, fheroes2::AGG::GetTIL( TIL::STON, 32 + ( mp.y % 4 ), 0 ), mp );
-    }
-    else {
-        area.DrawTile( dst, fheroes2::AGG::GetTIL( TIL::STON, ( std::abs( static_cast<int>( mp.y ) ) % 4 ) * 4 + std::abs( static_cast<int>( mp.x ) ) % 4, 0 ), mp );
-    }
-}
-
 void Maps::Tiles::RedrawAddon( fheroes2::Image & dst, const Addons & addon, const Rect & visibleTileROI, bool isPuzzleDraw, const Interface::GameArea & area ) const
 {
     if ( addon.empty() ) {
@@ -1789,7 +1787,8 @@ std::string Maps::Tiles::String( void ) const
     }
 
     if ( MP2::isCaptureObject( GetObject( false ) ) ) {
-        const CapturedObject & co = world.GetCapturedObject( GetIndex() );
+        const World & constWorld = world;
+        const CapturedObject & co = constWorld.GetCapturedObject( GetIndex() );
 
         os << "capture color   : " << Color::String( co.objcol.second ) << std::endl;
         if ( co.guardians.isValid() ) {
@@ -1823,15 +1822,7 @@ bool TileIsGround( s32 index, int ground )
 
 bool Maps::Tiles::validateWaterRules( bool fromWater ) const
 {
-    const bool tileIsWater = isWater();
-    if ( fromWater )
-        return mp2_object == MP2::OBJ_COAST || ( tileIsWater && mp2_object != MP2::OBJ_BOAT );
-
-    // if we're not in water but tile is; allow movement in three cases
-    if ( tileIsWater )
-        return mp2_object == MP2::OBJ_SHIPWRECK || mp2_object == MP2::OBJ_HEROES || mp2_object == MP2::OBJ_BOAT;
-
-    return true;
+    return isValidWaterMove( isWater(), mp2_object, fromWater );
 }
 
 bool Maps::Tiles::isPassable( int direct, bool fromWater, bool skipfog, const int heroColor ) const
@@ -1845,6 +1836,34 @@ bool Maps::Tiles::isPassable( int direct, bool fromWater, bool skipfog, const in
     return ( direct & tilePassable ) != 0;
 }
 
+bool Maps::TileInfo::validateWaterRules( bool fromWater ) const
+{
+    return isValidWaterMove( isWater, object, fromWater );
+}
+
+bool Maps::TileInfo::isPassable( int direct, bool fromWater, bool skipfog, const int heroColor ) const
+{
+    if ( !skipfog && isFog( heroColor ) )
+        return false;
+
+    if ( !validateWaterRules( fromWater ) )
+        return false;
+
+    return ( direct & passable ) != 0;
+}
+
+Maps::TileInfo Maps::Tiles::GetTileInfo() const
+{
+    TileInfo info;
+    info.passable = tilePassable;
+    info.ground = static_cast<uint16_t>( GetGround() );
+    info.object = mp2_object;
+    info.fogColors = fog_colors;
+    info.isWater = isWater();
+    info.isRoad = isRoad();
+    return info;
+}
+
 void Maps::Tiles::SetObjectPassable( bool pass )
 {
     switch ( GetObject( false ) ) {
@@ -1853,6 +1872,7 @@ void Maps::Tiles::SetObjectPassable( bool pass )
             tilePassable |= Direction::TOP_LEFT;
         else
             tilePassable &= ~Direction::TOP_LEFT;
+        world.updateTileInfo( GetIndex() );
         break;
 
     default:
@@ -2154,6 +2174,8 @@ void Maps::Tiles::RemoveObjectSprite( void )
         Remove( uniq );
         break;
     }
+
+    world.updateTileInfo( GetIndex() );
 }
 
 void Maps::Tiles::RemoveJailSprite( void )
@@ -2344,6 +2366,7 @@ std::pair<uint32_t, uint32_t> Maps::Tiles::GetMonsterSpriteIndices( const Tiles
 void Maps::Tiles::ClearFog( int colors )
 {
     fog_colors &= ~colors;
+    world.updateTileInfo( GetIndex() );
 }
 
 int Maps::Tiles::GetFogDirections( int color ) const
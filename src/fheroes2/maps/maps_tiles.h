@@ -113,6 +113,26 @@ namespace Maps
         void Remove( u32 uniq );
     };
 
+    // Compact copy of the tile properties used by pathfinding. World keeps them in a contiguous array,
+    // so hot loops don't have to touch full Tiles objects.
+    struct TileInfo
+    {
+        uint16_t passable = DIRECTION_ALL;
+        uint16_t ground = 0;
+        uint8_t object = 0;
+        uint8_t fogColors = Color::ALL;
+        bool isWater = false;
+        bool isRoad = false;
+
+        bool isFog( const int colors ) const
+        {
+            return ( fogColors & colors ) == colors;
+        }
+
+        bool validateWaterRules( bool fromWater ) const;
+        bool isPassable( int direct, bool fromWater, bool skipfog, const int heroColor ) const;
+    };
+
     class Tiles
     {
     public:
@@ -160,6 +180,7 @@ namespace Maps
         u32 TileSpriteShape( void ) const;
 
         const fheroes2::Image & GetTileSurface( void ) const;
+        static const fheroes2::Image & GetEmptyTileSurface( const Point & mp ); // for tiles outside of World Map
 
         bool isObject( int obj ) const;
         bool hasSpriteAnimation() const;
@@ -189,13 +210,13 @@ namespace Maps
 
         void FixObject( void );
 
+        TileInfo GetTileInfo() const;
+
         uint32_t GetRegion() const;
         void UpdateRegion( uint32_t newRegionID );
         void UpdatePassable( void );
         void CaptureFlags32( int obj, int col );
 
-        void RedrawTile( fheroes2::Image & dst, const Rect & visibleTileROI, const Interface::GameArea & gameArea ) const;
-        static void RedrawEmptyTile( fheroes2::Image & dst, const Point & mp, const Rect & visibleTileROI );
         void RedrawBottom( fheroes2::Image & dst, const Rect & visibleTileROI, bool isPuzzleDraw, const Interface::GameArea & gameArea ) const;
         void RedrawBottom4Hero( fheroes2::Image & dst, const Rect & visibleTileROI, const Interface::GameArea & gameArea ) const;
         void RedrawTop( fheroes2::Image & dst, const Rect & visibleTileROI, const Interface::GameArea & gameArea ) const;
@@ -413,12 +413,18 @@ Monster Maps::Tiles::QuantityMonster( void ) const
         break;
     }
 
-    return MP2::isCaptureObject( GetObject( false ) ) ? world.GetCapturedObject( GetIndex() ).GetTroop() : Monster( Monster::UNKNOWN );
+    if ( MP2::isCaptureObject( GetObject( false ) ) ) {
+        const World & constWorld = world;
+        return constWorld.GetCapturedObject( GetIndex() ).GetTroop();
+    }
+
+    return Monster( Monster::UNKNOWN );
 }
 
 Troop Maps::Tiles::QuantityTroop( void ) const
 {
-    return MP2::isCaptureObject( GetObject( false ) ) ? world.GetCapturedObject( GetIndex() ).GetTroop() : Troop( QuantityMonster(), MonsterCount() );
+    const World & constWorld = world;
+    return MP2::isCaptureObject( GetObject( false ) ) ? constWorld.GetCapturedObject( GetIndex() ).GetTroop() : Troop( QuantityMonster(), MonsterCount() );
 }
 
 void Maps::Tiles::QuantityReset( void )
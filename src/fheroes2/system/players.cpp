@@ -41,6 +41,12 @@ namespace
     {
         ST_INGAME = 0x2000
     };
+
+    bool SortPlayers( const Player * player1, const Player * player2 )
+    {
+        return ( player1->isControlHuman() && !player2->isControlHuman() )
+               || ( ( player1->isControlHuman() == player2->isControlHuman() ) && ( player1->GetColor() < player2->GetColor() ) );
+    }
 }
 
 void PlayerFocusReset( Player * player )
@@ -383,6 +389,13 @@ int Players::GetActualColors( void ) const
     return res;
 }
 
+std::vector<Player *> Players::getInTurnOrder() const
+{
+    std::vector<Player *> sortedPlayers( begin(), end() );
+    std::sort( sortedPlayers.begin(), sortedPlayers.end(), SortPlayers );
+    return sortedPlayers;
+}
+
 Player * Players::GetCurrent( void )
 {
     return Get( current_color );
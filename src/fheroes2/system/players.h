@@ -166,6 +166,9 @@ public:
     int GetActualColors( void ) const;
     std::string String( void ) const;
 
+    // human players go first, then players of each kind in color order
+    std::vector<Player *> getInTurnOrder() const;
+
     Player * GetCurrent( void );
     const Player * GetCurrent( void ) const;
 
@@ -36,7 +36,7 @@
 
 enum
 {
-    // ??? = 0x00000001,
+    GLOBAL_HEADLESS = 0x00000001, // nothing is drawn while the AI plays, not saved in the config
     // ??? = 0x00000002,
     GLOBAL_PRICELOYALTY = 0x00000004,
 
@@ -343,6 +343,7 @@ Settings::Settings()
     , music_volume( 6 )
     , _musicType( MUSIC_EXTERNAL )
     , _controllerPointerSpeed( 10 )
+    , _resourceCacheSize( 0 )
     , heroes_speed( DEFAULT_SPEED_DELAY )
     , ai_speed( DEFAULT_SPEED_DELAY )
     , scroll_speed( SCROLL_NORMAL )
@@ -646,6 +647,12 @@ bool Settings::Read( const std::string & filename )
             _controllerPointerSpeed = 0;
     }
 
+    if ( config.Exists( "resource cache size" ) ) {
+        _resourceCacheSize = config.IntParams( "resource cache size" );
+        if ( _resourceCacheSize < 0 )
+            _resourceCacheSize = 0;
+    }
+
 #ifndef WITH_TTF
     opt_global.ResetModes( GLOBAL_USEUNICODE );
 #endif
@@ -794,6 +801,9 @@ std::string Settings::String( void ) const
     os << std::endl << "# controller pointer speed: 0 - 100" << std::endl;
     os << "controller pointer speed = " << _controllerPointerSpeed << std::endl;
 
+    os << std::endl << "# memory limit of cached sprites, tiles and sounds in MB, 0 - unlimited" << std::endl;
+    os << "resource cache size = " << _resourceCacheSize << std::endl;
+
     return os.str();
 }
 
@@ -1120,6 +1130,11 @@ bool Settings::PriceLoyaltyVersion( void ) const
     return opt_global.Modes( GLOBAL_PRICELOYALTY );
 }
 
+bool Settings::Headless( void ) const
+{
+    return opt_global.Modes( GLOBAL_HEADLESS );
+}
+
 bool Settings::LoadedGameVersion( void ) const
 {
     // 0x80 value should be same as in Game::TYPE_LOADFILE enumeration value
@@ -1374,6 +1389,11 @@ int Settings::controllerPointerSpeed() const
     return _controllerPointerSpeed;
 }
 
+int Settings::ResourceCacheSize() const
+{
+    return _resourceCacheSize;
+}
+
 void Settings::SetUnicode( bool f )
 {
     f ? opt_global.SetModes( GLOBAL_USEUNICODE ) : opt_global.ResetModes( GLOBAL_USEUNICODE );
@@ -1391,6 +1411,11 @@ void Settings::SetPriceLoyaltyVersion( bool set )
     }
 }
 
+void Settings::SetHeadless( bool f )
+{
+    f ? opt_global.SetModes( GLOBAL_HEADLESS ) : opt_global.ResetModes( GLOBAL_HEADLESS );
+}
+
 void Settings::SetEvilInterface( bool f )
 {
     f ? ExtSetModes( GAME_EVIL_INTERFACE ) : ExtResetModes( GAME_EVIL_INTERFACE );
@@ -178,6 +178,7 @@ public:
     bool UseAltResource( void ) const;
     bool PriceLoyaltyVersion( void ) const;
     bool LoadedGameVersion( void ) const;
+    bool Headless( void ) const;
     bool MusicExt( void ) const;
     bool MusicMIDI( void ) const;
     bool MusicCD( void ) const;
@@ -242,6 +243,7 @@ public:
     void SetDebug( int );
     void SetUnicode( bool );
     void SetPriceLoyaltyVersion( bool set = true );
+    void SetHeadless( bool );
     void SetGameDifficulty( int );
     void SetEvilInterface( bool );
     void SetHideInterface( bool );
@@ -305,6 +307,7 @@ public:
     Point LossMapsPositionObject( void ) const;
     u32 LossCountDays( void ) const;
     int controllerPointerSpeed() const;
+    int ResourceCacheSize() const; // in MB, 0 means no limit
 
     std::string GetProgramPath( void ) const
     {
@@ -369,6 +372,7 @@ private:
     int music_volume;
     MusicSource _musicType;
     int _controllerPointerSpeed;
+    int _resourceCacheSize;
     int heroes_speed;
     int ai_speed;
     int scroll_speed;
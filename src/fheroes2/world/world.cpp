@@ -121,6 +121,14 @@ CapturedObject & CapturedObjects::Get( s32 index )
     return my[index];
 }
 
+const CapturedObject & CapturedObjects::Get( s32 index ) const
+{
+    static const CapturedObject empty;
+
+    const_iterator it = find( index );
+    return it != end() ? ( *it ).second : empty;
+}
+
 void CapturedObjects::SetColor( s32 index, int col )
 {
     Get( index ).SetColor( col );
@@ -270,6 +278,8 @@ void World::Reset( void )
 {
     // maps tiles
     vec_tiles.clear();
+    _tileInfo.clear();
+    _tileProtection.clear();
 
     // kingdoms
     vec_kingdoms.clear();
@@ -337,6 +347,8 @@ void World::NewMaps( u32 sw, u32 sh )
         ( *it ).Init( std::distance( vec_tiles.begin(), it ), mp2tile );
     }
 
+    resetTileInfo();
+
     // reset current maps info
     Maps::FileInfo fi;
     fi.size_w = w();
@@ -644,28 +656,53 @@ const std::string & World::GetRumors( void )
     return *_rumor;
 }
 
-MapsIndexes World::GetTeleportEndPoints( s32 center ) const
+const MapsIndexes & World::GetTeleportEndPoints( s32 center ) const
 {
-    MapsIndexes result;
+    static const MapsIndexes emptyList;
 
-    const Maps::Tiles & entrance = GetTiles( center );
-    if ( _allTeleporters.size() > 1 && entrance.GetObject( false ) == MP2::OBJ_STONELITHS ) {
-        for ( MapsIndexes::const_iterator it = _allTeleporters.begin(); it != _allTeleporters.end(); ++it ) {
-            const Maps::Tiles & tile = GetTiles( *it );
-            if ( *it != center && tile.GetObjectSpriteIndex() == entrance.GetObjectSpriteIndex() && tile.GetObject() != MP2::OBJ_HEROES
-                 && tile.isWater() == entrance.isWater() ) {
-                result.push_back( *it );
-            }
-        }
+    // most of the tiles aren't stoneliths, skip the search for them
+    const int object = _tileInfo[center].object;
+    if ( object != MP2::OBJ_STONELITHS && object != MP2::OBJ_HEROES )
+        return emptyList;
+
+    const auto it = _teleportEndPoints.find( center );
+    return it != _teleportEndPoints.end() ? it->second : emptyList;
+}
+
+const MapsIndexes & World::getAllTeleporters() const
+{
+    return _allTeleporters;
+}
+
+void World::updateTeleportEndPoints()
+{
+    _teleportEndPoints.clear();
+
+    if ( _allTeleporters.size() < 2 )
+        return;
+
+    // stoneliths with the same sprite on the same kind of terrain are connected
+    std::map<std::pair<uint8_t, bool>, MapsIndexes> groups;
+    for ( const int32_t index : _allTeleporters ) {
+        const Maps::Tiles & tile = vec_tiles[index];
+        groups[std::make_pair( tile.GetObjectSpriteIndex(), tile.isWater() )].push_back( index );
     }
 
-    return result;
+    for ( const int32_t index : _allTeleporters ) {
+        const Maps::Tiles & entrance = vec_tiles[index];
+        MapsIndexes & endPoints = _teleportEndPoints[index];
+
+        for ( const int32_t exitIndex : groups[std::make_pair( entrance.GetObjectSpriteIndex(), entrance.isWater() )] ) {
+            if ( exitIndex != index && vec_tiles[exitIndex].GetObject() != MP2::OBJ_HEROES )
+                endPoints.push_back( exitIndex );
+        }
+    }
 }
 
 /* return random teleport destination */
 s32 World::NextTeleport( s32 index ) const
 {
-    const MapsIndexes teleports = GetTeleportEndPoints( index );
+    const MapsIndexes & teleports = GetTeleportEndPoints( index );
     if ( teleports.empty() ) {
         DEBUG_LOG( DBG_GAME, DBG_WARN, "not found" );
         return index;
@@ -674,41 +711,67 @@ s32 World::NextTeleport( s32 index ) const
     return Rand::Get( teleports );
 }
 
-MapsIndexes World::GetWhirlpoolEndPoints( s32 center ) const
+const MapsIndexes & World::GetWhirlpoolEndPoints( s32 center ) const
 {
-    if ( MP2::OBJ_WHIRLPOOL == GetTiles( center ).GetObject( false ) ) {
-        std::map<s32, MapsIndexes> uniq_whirlpools;
+    static const MapsIndexes emptyList;
 
-        for ( MapsIndexes::const_iterator it = _whirlpoolTiles.begin(); it != _whirlpoolTiles.end(); ++it ) {
-            uniq_whirlpools[GetTiles( *it ).GetObjectUID()].push_back( *it );
-        }
+    const auto it = _whirlpoolIds.find( center );
+    if ( it == _whirlpoolIds.end() )
+        return emptyList;
 
-        if ( 2 > uniq_whirlpools.size() ) {
-            DEBUG_LOG( DBG_GAME, DBG_WARN, "is empty" );
-            return MapsIndexes();
-        }
+    if ( 2 > _whirlpoolEndPoints.size() ) {
+        DEBUG_LOG( DBG_GAME, DBG_WARN, "is empty" );
+        return emptyList;
+    }
 
-        const uint32_t currentUID = GetTiles( center ).GetObjectUID();
-        MapsIndexes uniqs;
-        uniqs.reserve( uniq_whirlpools.size() );
+    // pick one of the other whirlpools
+    uint32_t whirlpoolId = Rand::Get( static_cast<uint32_t>( _whirlpoolEndPoints.size() - 2 ) );
+    if ( whirlpoolId >= it->second )
+        ++whirlpoolId;
 
-        for ( std::map<s32, MapsIndexes>::const_iterator it = uniq_whirlpools.begin(); it != uniq_whirlpools.end(); ++it ) {
-            const u32 uniq = ( *it ).first;
-            if ( uniq == currentUID )
-                continue;
-            uniqs.push_back( uniq );
-        }
+    return _whirlpoolEndPoints[whirlpoolId];
+}
+
+const MapsIndexes & World::getAllWhirlpoolExits( s32 center ) const
+{
+    static const MapsIndexes emptyList;
+
+    const auto it = _whirlpoolIds.find( center );
+    return it != _whirlpoolIds.end() ? _whirlpoolExits[it->second] : emptyList;
+}
 
-        return uniq_whirlpools[Rand::Get( uniqs )];
+void World::updateWhirlpoolEndPoints()
+{
+    _whirlpoolIds.clear();
+    _whirlpoolEndPoints.clear();
+    _whirlpoolExits.clear();
+
+    // one whirlpool takes several tiles with the same UID
+    std::map<s32, MapsIndexes> uniqWhirlpools;
+    for ( const int32_t index : _whirlpoolTiles ) {
+        uniqWhirlpools[vec_tiles[index].GetObjectUID()].push_back( index );
+    }
+
+    for ( const auto & whirlpool : uniqWhirlpools ) {
+        for ( const int32_t index : whirlpool.second )
+            _whirlpoolIds[index] = _whirlpoolEndPoints.size();
+
+        _whirlpoolEndPoints.push_back( whirlpool.second );
     }
 
-    return MapsIndexes();
+    _whirlpoolExits.resize( _whirlpoolEndPoints.size() );
+    for ( size_t id = 0; id < _whirlpoolExits.size(); ++id ) {
+        for ( const int32_t index : _whirlpoolTiles ) {
+            if ( _whirlpoolIds[index] != id )
+                _whirlpoolExits[id].push_back( index );
+        }
+    }
 }
 
 /* return random whirlpools destination */
 s32 World::NextWhirlpool( s32 index ) const
 {
-    const MapsIndexes whilrpools = GetWhirlpoolEndPoints( index );
+    const MapsIndexes & whilrpools = GetWhirlpoolEndPoints( index );
     if ( whilrpools.empty() ) {
         DEBUG_LOG( DBG_GAME, DBG_WARN, "is full" );
         return index;
@@ -773,6 +836,11 @@ CapturedObject & World::GetCapturedObject( s32 index )
     return map_captureobj.Get( index );
 }
 
+const CapturedObject & World::GetCapturedObject( s32 index ) const
+{
+    return map_captureobj.Get( index );
+}
+
 void World::ResetCapturedObjects( int color )
 {
     map_captureobj.ResetColor( color );
@@ -1051,14 +1119,64 @@ void World::resetPathfinder()
     AI::Get().resetPathfinder();
 }
 
+void World::resetTileInfo()
+{
+    _tileInfo.resize( vec_tiles.size() );
+    for ( size_t idx = 0; idx < vec_tiles.size(); ++idx ) {
+        _tileInfo[idx] = vec_tiles[idx].GetTileInfo();
+    }
+
+    _tileProtection.resize( vec_tiles.size() );
+    for ( size_t idx = 0; idx < vec_tiles.size(); ++idx ) {
+        _tileProtection[idx] = Maps::CalculateTileProtection( static_cast<s32>( idx ) );
+    }
+}
+
+void World::updateTileInfo( const int32_t tileId )
+{
+    // tiles are changed while the map is being loaded too, all data is collected after that
+    if ( tileId < 0 || static_cast<size_t>( tileId ) >= _tileInfo.size() )
+        return;
+
+    const Maps::TileInfo previous = _tileInfo[tileId];
+    _tileInfo[tileId] = vec_tiles[tileId].GetTileInfo();
+    const Maps::TileInfo & current = _tileInfo[tileId];
+
+    // a hero entered or left a stonelith
+    if ( previous.object != current.object && ( previous.object == MP2::OBJ_STONELITHS || current.object == MP2::OBJ_STONELITHS ) )
+        updateTeleportEndPoints();
+
+    // protection of the tile and its neighbours depends on monsters, objects and passability but not on fog
+    if ( previous.object == current.object && previous.passable == current.passable && previous.isWater == current.isWater )
+        return;
+
+    _tileProtection[tileId] = Maps::CalculateTileProtection( tileId );
+    for ( const int direction : Direction::All() ) {
+        if ( Maps::isValidDirection( tileId, direction ) ) {
+            const int32_t neighbour = Maps::GetDirectionIndex( tileId, direction );
+            _tileProtection[neighbour] = Maps::CalculateTileProtection( neighbour );
+        }
+    }
+}
+
+void World::updatePathfinder( int tileIndex )
+{
+    _pathfinder.markTileAsChanged( tileIndex );
+    AI::Get().updatePathfinder( tileIndex );
+}
+
 void World::PostLoad()
 {
     // update tile passable
     std::for_each( vec_tiles.begin(), vec_tiles.end(), []( Maps::Tiles & tile ) { tile.UpdatePassable(); } );
 
+    resetTileInfo();
+
     // cache data that's accessed often
     _allTeleporters = Maps::GetObjectPositions( MP2::OBJ_STONELITHS, true );
     _whirlpoolTiles = Maps::GetObjectPositions( MP2::OBJ_WHIRLPOOL, true );
+    updateTeleportEndPoints();
+    updateWhirlpoolEndPoints();
 
     resetPathfinder();
     ComputeStaticAnalysis();
@@ -22,6 +22,7 @@
 #ifndef H2WORLD_H
 #define H2WORLD_H
 
+#include <map>
 #include <vector>
 
 #include "artifact_ultimate.h"
@@ -89,6 +90,10 @@ struct CapturedObject
     {
         return guardians;
     }
+    const Troop & GetTroop( void ) const
+    {
+        return guardians;
+    }
 
     void Set( int obj, int col )
     {
@@ -117,6 +122,8 @@ struct CapturedObjects : std::map<s32, CapturedObject>
     void ResetColor( int );
 
     CapturedObject & Get( s32 );
+    // read-only lookup which doesn't insert missing objects so it's safe to use from worker threads
+    const CapturedObject & Get( s32 ) const;
     Funds TributeCapturedObject( int col, int obj );
 
     u32 GetCount( int, int ) const;
@@ -183,6 +190,20 @@ public:
     const Maps::Tiles & GetTiles( const int32_t tileId ) const;
     Maps::Tiles & GetTiles( const int32_t tileId );
 
+    // Compact tile data for hot loops like pathfinding, Maps::Tiles keep it up to date
+    const Maps::TileInfo & getTileInfo( const int32_t tileId ) const
+    {
+        return _tileInfo[tileId];
+    }
+
+    void updateTileInfo( const int32_t tileId );
+
+    // Directions of the monsters guarding the tile, see Maps::CalculateTileProtection
+    uint16_t getTileProtection( const int32_t tileId ) const
+    {
+        return _tileProtection[tileId];
+    }
+
     void InitKingdoms( void );
 
     Kingdom & GetKingdom( int color );
@@ -229,10 +250,13 @@ public:
     const std::string & GetRumors( void );
 
     s32 NextTeleport( s32 ) const;
-    MapsIndexes GetTeleportEndPoints( s32 ) const;
+    const MapsIndexes & GetTeleportEndPoints( s32 ) const;
+    const MapsIndexes & getAllTeleporters() const;
 
     s32 NextWhirlpool( s32 ) const;
-    MapsIndexes GetWhirlpoolEndPoints( s32 ) const;
+    const MapsIndexes & GetWhirlpoolEndPoints( s32 ) const;
+    // all tiles of the other whirlpools, unlike GetWhirlpoolEndPoints doesn't pick one of them randomly
+    const MapsIndexes & getAllWhirlpoolExits( s32 ) const;
 
     void CaptureObject( s32, int col );
     u32 CountCapturedObject( int obj, int col ) const;
@@ -241,6 +265,7 @@ public:
     int ColorCapturedObject( s32 ) const;
     void ResetCapturedObjects( int );
     CapturedObject & GetCapturedObject( s32 );
+    const CapturedObject & GetCapturedObject( s32 ) const;
     ListActions * GetListActions( s32 );
 
     void ActionForMagellanMaps( int color );
@@ -260,12 +285,14 @@ public:
     void RemoveMapObject( const MapObjectSimple * );
     const MapRegion & getRegion( size_t id ) const;
     size_t getRegionCount() const;
+    const RegionGraph & getRegionGraph() const;
 
     bool isTileBlocked( int toTile, bool fromWater ) const;
     bool isValidPath( int index, int direction, const int heroColor ) const;
     uint32_t getDistance( const Heroes & hero, int targetIndex );
     std::list<Route::Step> getPath( const Heroes & hero, int targetIndex );
     void resetPathfinder();
+    void updatePathfinder( int tileIndex );
 
     void ComputeStaticAnalysis();
     static u32 GetUniq( void );
@@ -283,6 +310,9 @@ private:
     void MonthOfMonstersAction( const Monster & );
     void ProcessNewMap();
     void PostLoad();
+    void resetTileInfo();
+    void updateTeleportEndPoints();
+    void updateWhirlpoolEndPoints();
     void pickRumor();
 
 private:
@@ -320,9 +350,16 @@ private:
     MapObjects map_objects;
 
     // This data isn't serialized
+    std::vector<Maps::TileInfo> _tileInfo;
+    std::vector<uint16_t> _tileProtection;
     Maps::Indexes _allTeleporters;
     Maps::Indexes _whirlpoolTiles;
+    std::map<int32_t, MapsIndexes> _teleportEndPoints; // free exits of every stonelith, updated when heroes enter or leave them
+    std::map<int32_t, size_t> _whirlpoolIds; // tile index to whirlpool, whirlpools are ordered by UID
+    std::vector<MapsIndexes> _whirlpoolEndPoints; // tiles of every whirlpool
+    std::vector<MapsIndexes> _whirlpoolExits; // tiles of all other whirlpools for every whirlpool
     std::vector<MapRegion> _regions;
+    RegionGraph _regionGraph;
     PlayerWorldPathfinder _pathfinder;
 
     uint32_t _seed;
@@ -18,22 +18,26 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <set>
 
 #include "ground.h"
 #include "logging.h"
+#include "thread_pool.h"
 #include "world.h"
 #include "world_pathfinding.h"
 
 bool isTileBlockedForArmy( int tileIndex, int color, double armyStrength, bool fromWater )
 {
-    const Maps::Tiles & tile = world.GetTiles( tileIndex );
-    const bool toWater = tile.isWater();
-    const int object = tile.GetObject();
+    const Maps::TileInfo & tileInfo = world.getTileInfo( tileIndex );
+    const bool toWater = tileInfo.isWater;
+    const int object = tileInfo.object;
 
     // Special cases: check if we can defeat the Hero/Monster and pass through
     if ( object == MP2::OBJ_HEROES ) {
-        const Heroes * otherHero = tile.GetHeroes();
+        const Heroes * otherHero = world.GetTiles( tileIndex ).GetHeroes();
         if ( otherHero ) {
             if ( otherHero->isFriends( color ) )
                 return true;
@@ -42,11 +46,11 @@ bool isTileBlockedForArmy( int tileIndex, int color, double armyStrength, bool f
         }
     }
 
-    if ( object == MP2::OBJ_MONSTER || ( object == MP2::OBJ_ARTIFACT && tile.QuantityVariant() > 5 ) )
-        return Army( tile ).GetStrength() > armyStrength;
+    if ( object == MP2::OBJ_MONSTER || ( object == MP2::OBJ_ARTIFACT && world.GetTiles( tileIndex ).QuantityVariant() > 5 ) )
+        return Army( world.GetTiles( tileIndex ) ).GetStrength() > armyStrength;
 
     // check if AI has the key for the barrier
-    if ( object == MP2::OBJ_BARRIER && world.GetKingdom( color ).IsVisitTravelersTent( tile.QuantityColor() ) )
+    if ( object == MP2::OBJ_BARRIER && world.GetKingdom( color ).IsVisitTravelersTent( world.GetTiles( tileIndex ).QuantityColor() ) )
         return false;
 
     // if none of the special cases apply, check if tile can be moved on
@@ -58,9 +62,9 @@ bool isTileBlockedForArmy( int tileIndex, int color, double armyStrength, bool f
 
 bool World::isTileBlocked( int tileIndex, bool fromWater ) const
 {
-    const Maps::Tiles & tile = world.GetTiles( tileIndex );
-    const bool toWater = tile.isWater();
-    const int object = tile.GetObject();
+    const Maps::TileInfo & tileInfo = _tileInfo[tileIndex];
+    const bool toWater = tileInfo.isWater;
+    const int object = tileInfo.object;
 
     if ( object == MP2::OBJ_HEROES || object == MP2::OBJ_MONSTER || object == MP2::OBJ_BOAT )
         return true;
@@ -76,31 +80,31 @@ bool World::isTileBlocked( int tileIndex, bool fromWater ) const
 
 bool World::isValidPath( int index, int direction, const int heroColor ) const
 {
-    const Maps::Tiles & fromTile = GetTiles( index );
-    const Maps::Tiles & toTile = GetTiles( Maps::GetDirectionIndex( index, direction ) );
-    const bool fromWater = fromTile.isWater();
+    const Maps::TileInfo & fromTile = _tileInfo[index];
+    const Maps::TileInfo & toTile = _tileInfo[Maps::GetDirectionIndex( index, direction )];
+    const bool fromWater = fromTile.isWater;
 
     // check corner water/coast
     if ( fromWater ) {
         const int mapWidth = world.w();
         switch ( direction ) {
         case Direction::TOP_LEFT:
-            if ( !GetTiles( index - mapWidth ).isWater() || !GetTiles( index - 1 ).isWater() )
+            if ( !_tileInfo[index - mapWidth].isWater || !_tileInfo[index - 1].isWater )
                 return false;
             break;
 
         case Direction::TOP_RIGHT:
-            if ( !GetTiles( index - mapWidth ).isWater() || !GetTiles( index + 1 ).isWater() )
+            if ( !_tileInfo[index - mapWidth].isWater || !_tileInfo[index + 1].isWater )
                 return false;
             break;
 
         case Direction::BOTTOM_RIGHT:
-            if ( !GetTiles( index + mapWidth ).isWater() || !GetTiles( index + 1 ).isWater() )
+            if ( !_tileInfo[index + mapWidth].isWater || !_tileInfo[index + 1].isWater )
                 return false;
             break;
 
         case Direction::BOTTOM_LEFT:
-            if ( !GetTiles( index + mapWidth ).isWater() || !GetTiles( index - 1 ).isWater() )
+            if ( !_tileInfo[index + mapWidth].isWater || !_tileInfo[index - 1].isWater )
                 return false;
             break;
 
@@ -115,6 +119,53 @@ bool World::isValidPath( int index, int direction, const int heroColor ) const
     return toTile.isPassable( Direction::Reflect( direction ), fromWater, false, heroColor );
 }
 
+namespace
+{
+    // Shared by all pathfinders, AI workers search in parallel
+    std::atomic<uint64_t> searchCount( 0 );
+
+    // Lower bound of movement cost between two tiles: every step is done by road
+    uint32_t getMinimalMovementCost( int from, int to )
+    {
+        const int32_t width = world.w();
+        const uint32_t diffX = static_cast<uint32_t>( std::abs( from % width - to % width ) );
+        const uint32_t diffY = static_cast<uint32_t>( std::abs( from / width - to / width ) );
+        const uint32_t diagonalSteps = std::min( diffX, diffY );
+        const uint32_t straightSteps = std::max( diffX, diffY ) - diagonalSteps;
+
+        return straightSteps * Maps::Ground::roadPenalty + diagonalSteps * ( Maps::Ground::roadPenalty * 3 / 2 );
+    }
+
+    // Same as above, but stoneliths can be used on the way
+    uint32_t getMinimalMovementCostWithTeleports( int from, int to )
+    {
+        uint32_t toTeleport = UINT32_MAX;
+        uint32_t fromTeleport = UINT32_MAX;
+        for ( const int teleportIdx : world.getAllTeleporters() ) {
+            toTeleport = std::min( toTeleport, getMinimalMovementCost( from, teleportIdx ) );
+            fromTeleport = std::min( fromTeleport, getMinimalMovementCost( teleportIdx, to ) );
+        }
+
+        const uint32_t direct = getMinimalMovementCost( from, to );
+        if ( toTeleport == UINT32_MAX )
+            return direct;
+
+        return std::min( direct, toTeleport + fromTeleport );
+    }
+
+    // Lowest possible cost of a straight move to the tile
+    uint32_t getMinimalStepPenalty( const Maps::Tiles & tile )
+    {
+        const uint32_t penalty = Maps::Ground::GetPenalty( tile, Skill::Level::EXPERT );
+        return tile.isRoad() ? std::min( penalty, Maps::Ground::roadPenalty ) : penalty;
+    }
+}
+
+WorldPathfinder::WorldPathfinder()
+    // a single diagonal move plus the change of goal heuristic along it
+    : _nodesToExplore( Maps::Ground::slowestMovePenalty * 3 )
+{}
+
 void WorldPathfinder::checkWorldSize()
 {
     const size_t worldSize = world.getSize();
@@ -145,8 +196,8 @@ bool WorldPathfinder::isBlockedByObject( int target, bool fromWater ) const
 
 uint32_t WorldPathfinder::getMovementPenalty( int from, int target, int direction, uint8_t skill ) const
 {
-    const Maps::Tiles & tileTo = world.GetTiles( target );
-    uint32_t penalty = ( world.GetTiles( from ).isRoad() && tileTo.isRoad() ) ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( tileTo, skill );
+    const Maps::TileInfo & tileTo = world.getTileInfo( target );
+    uint32_t penalty = ( world.getTileInfo( from ).isRoad && tileTo.isRoad ) ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( tileTo.ground, skill );
 
     // diagonal move costs 50% extra
     if ( Direction::isDiagonal( direction ) )
@@ -155,7 +206,42 @@ uint32_t WorldPathfinder::getMovementPenalty( int from, int target, int directio
     return penalty;
 }
 
-void WorldPathfinder::processWorldMap( int pathStart )
+uint32_t WorldPathfinder::getGoalHeuristic( int index ) const
+{
+    if ( _pathEnd == -1 )
+        return 0;
+
+    return std::min( getMinimalMovementCost( index, _pathEnd ), _goalHeuristicLimit );
+}
+
+uint32_t WorldPathfinder::getGoalHeuristicLimit( int ) const
+{
+    return UINT32_MAX;
+}
+
+void WorldPathfinder::addNodeToExplore( int index )
+{
+    _nodesToExplore.push( index, _cache[index]._cost + getGoalHeuristic( index ) );
+}
+
+void WorldPathfinder::markTileAsChanged( int index )
+{
+    // nothing to update if there is no calculated map yet
+    if ( _pathStart == -1 || index < 0 || static_cast<size_t>( index ) >= _cache.size() )
+        return;
+
+    // too many changes have piled up, it's cheaper to process the whole map again. Only the current result is dropped:
+    // results kept by AIWorldPathfinder for other armies count their own changes.
+    if ( _changedTiles.size() >= maxChangedTiles ) {
+        _pathStart = -1;
+        _changedTiles.clear();
+        return;
+    }
+
+    _changedTiles.push_back( index );
+}
+
+void WorldPathfinder::processWorldMap( int pathStart, int pathEnd )
 {
     const bool fromWater = world.GetTiles( pathStart ).isWater();
 
@@ -165,15 +251,146 @@ void WorldPathfinder::processWorldMap( int pathStart )
     }
     _cache[pathStart] = PathfindingNode( -1, 0, 0 );
 
-    std::vector<int> nodesToExplore;
-    nodesToExplore.push_back( pathStart );
+    _pathEnd = pathEnd;
+    _goalHeuristicLimit = ( pathEnd != -1 ) ? getGoalHeuristicLimit( pathEnd ) : 0;
 
-    for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
-        processCurrentNode( nodesToExplore, pathStart, nodesToExplore[lastProcessedNode], fromWater );
+    _changedTiles.clear();
+
+    _nodesToExplore.clear();
+    addNodeToExplore( pathStart );
+
+    processQueue( pathStart, pathEnd, fromWater );
+}
+
+void WorldPathfinder::updateWorldMap()
+{
+    enum : uint8_t
+    {
+        NODE_UNKNOWN,
+        NODE_IN_PROGRESS,
+        NODE_VALID,
+        NODE_INVALID,
+        NODE_BOUNDARY
+    };
+
+    const int pathStart = _pathStart;
+    const int mapSize = static_cast<int>( _cache.size() );
+
+    // a goal-directed search can't be continued for other nodes
+    if ( _pathEnd != -1 ) {
+        processWorldMap( pathStart );
+        return;
     }
+
+    _nodeState.assign( _cache.size(), NODE_UNKNOWN );
+
+    // passability and protection of a tile depend on its neighbours
+    for ( const int changedIdx : _changedTiles ) {
+        _nodeState[changedIdx] = NODE_INVALID;
+
+        for ( size_t i = 0; i < _mapOffset.size(); ++i ) {
+            if ( Maps::isValidDirection( changedIdx, Direction::All()[i] ) )
+                _nodeState[changedIdx + _mapOffset[i]] = NODE_INVALID;
+        }
+    }
+    _changedTiles.clear();
+
+    // the starting point is always reachable, its neighbours are relaxed again below
+    _nodeState[pathStart] = NODE_VALID;
+
+    // every node whose path goes through an invalid node is invalid too
+    std::vector<int> chain;
+    size_t invalidCount = 0;
+    for ( int idx = 0; idx < mapSize; ++idx ) {
+        int currentNode = idx;
+        while ( currentNode != -1 && _nodeState[currentNode] == NODE_UNKNOWN ) {
+            _nodeState[currentNode] = NODE_IN_PROGRESS;
+            chain.push_back( currentNode );
+            currentNode = _cache[currentNode]._from;
+        }
+
+        uint8_t state = NODE_VALID;
+        if ( currentNode != -1 ) {
+            // circular path (shouldn't happen) is treated as invalid
+            state = ( _nodeState[currentNode] == NODE_IN_PROGRESS ) ? static_cast<uint8_t>( NODE_INVALID ) : _nodeState[currentNode];
+        }
+
+        for ( const int nodeIdx : chain )
+            _nodeState[nodeIdx] = state;
+
+        chain.clear();
+
+        if ( _nodeState[idx] == NODE_INVALID )
+            ++invalidCount;
+    }
+
+    if ( invalidCount * 2 > _cache.size() ) {
+        processWorldMap( pathStart );
+        return;
+    }
+
+    const bool fromWater = world.GetTiles( pathStart ).isWater();
+
+    // reset invalid nodes and collect reachable valid nodes that could lead to them
+    // like in checkAdjacentNodes only nodes of the same terrain type as the starting one are explored further
+    std::vector<int> boundary;
+    auto addBoundaryNode = [this, pathStart, fromWater, &boundary]( int index ) {
+        if ( _nodeState[index] != NODE_VALID )
+            return;
+
+        if ( index == pathStart || ( _cache[index]._from != -1 && world.getTileInfo( index ).isWater == fromWater ) ) {
+            _nodeState[index] = NODE_BOUNDARY;
+            boundary.push_back( index );
+        }
+    };
+
+    for ( int idx = 0; idx < mapSize; ++idx ) {
+        if ( _nodeState[idx] != NODE_INVALID )
+            continue;
+
+        _cache[idx].resetNode();
+
+        for ( size_t i = 0; i < _mapOffset.size(); ++i ) {
+            if ( Maps::isValidDirection( idx, Direction::All()[i] ) )
+                addBoundaryNode( idx + _mapOffset[i] );
+        }
+
+        for ( const int teleportIdx : world.GetTeleportEndPoints( idx ) )
+            addBoundaryNode( teleportIdx );
+    }
+
+    _nodesToExplore.clear();
+    for ( const int nodeIdx : boundary )
+        addNodeToExplore( nodeIdx );
+
+    processQueue( pathStart, -1, fromWater );
 }
 
-void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater )
+uint64_t WorldPathfinder::getSearchCount()
+{
+    return searchCount.load();
+}
+
+void WorldPathfinder::processQueue( int pathStart, int pathEnd, bool fromWater )
+{
+    ++searchCount;
+
+    while ( !_nodesToExplore.empty() ) {
+        const int currentNodeIdx = _nodesToExplore.pop();
+
+        // a node is added again every time a cheaper way to it is found, skip outdated entries
+        if ( _nodesToExplore.currentPriority() != _cache[currentNodeIdx]._cost + getGoalHeuristic( currentNodeIdx ) )
+            continue;
+
+        processCurrentNode( pathStart, currentNodeIdx, fromWater );
+
+        // the cost of the destination is final once it is taken from the queue
+        if ( currentNodeIdx == pathEnd )
+            break;
+    }
+}
+
+void WorldPathfinder::checkAdjacentNodes( int pathStart, int currentNodeIdx, bool fromWater )
 {
     const Directions & directions = Direction::All();
     const PathfindingNode & currentNode = _cache[currentNodeIdx];
@@ -187,15 +404,15 @@ void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int
             const uint32_t moveCost = currentNode._cost + getMovementPenalty( currentNodeIdx, newIndex, directions[i], _pathfindingSkill );
             PathfindingNode & newNode = _cache[newIndex];
             if ( world.isValidPath( currentNodeIdx, directions[i], _currentColor ) && ( newNode._from == -1 || newNode._cost > moveCost ) ) {
-                const Maps::Tiles & tile = world.GetTiles( newIndex );
+                const Maps::TileInfo & tileInfo = world.getTileInfo( newIndex );
 
                 newNode._from = currentNodeIdx;
                 newNode._cost = moveCost;
-                newNode._objectID = tile.GetObject();
+                newNode._objectID = tileInfo.object;
 
                 // duplicates are allowed if we find a cheaper way there
-                if ( tile.isWater() == fromWater )
-                    nodesToExplore.push_back( newIndex );
+                if ( tileInfo.isWater == fromWater )
+                    addNodeToExplore( newIndex );
             }
         }
     }
@@ -208,6 +425,7 @@ void PlayerWorldPathfinder::reset()
     if ( _pathStart != -1 ) {
         _pathStart = -1;
         _currentColor = Color::NONE;
+        _changedTiles.clear();
         _pathfindingSkill = Skill::Level::EXPERT;
     }
 }
@@ -224,6 +442,9 @@ void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 
         processWorldMap( startIndex );
     }
+    else if ( !_changedTiles.empty() ) {
+        updateWorldMap();
+    }
 }
 
 std::list<Route::Step> PlayerWorldPathfinder::buildPath( int targetIndex ) const
@@ -257,16 +478,19 @@ std::list<Route::Step> PlayerWorldPathfinder::buildPath( int targetIndex ) const
 }
 
 // Follows regular (for user's interface) passability rules
-void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater )
+void PlayerWorldPathfinder::processCurrentNode( int pathStart, int currentNodeIdx, bool fromWater )
 {
-    const MapsIndexes & monsters = Maps::GetTilesUnderProtection( currentNodeIdx );
+    const uint16_t protection = world.getTileProtection( currentNodeIdx );
 
     // check if current tile is protected, can move only to adjacent monster
-    if ( currentNodeIdx != pathStart && !monsters.empty() ) {
-        for ( int monsterIndex : monsters ) {
-            const int direction = Maps::GetDirection( currentNodeIdx, monsterIndex );
+    if ( currentNodeIdx != pathStart && protection != 0 ) {
+        const Directions & directions = Direction::All();
 
-            if ( direction != Direction::UNKNOWN && direction != Direction::CENTER && world.isValidPath( currentNodeIdx, direction, _currentColor ) ) {
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            const int direction = directions[i];
+            const int monsterIndex = currentNodeIdx + _mapOffset[i];
+
+            if ( ( protection & direction ) && world.isValidPath( currentNodeIdx, direction, _currentColor ) ) {
                 // add straight to cache, can't move further from the monster
                 const uint32_t moveCost = _cache[currentNodeIdx]._cost + getMovementPenalty( currentNodeIdx, monsterIndex, direction, _pathfindingSkill );
                 PathfindingNode & monsterNode = _cache[monsterIndex];
@@ -278,7 +502,7 @@ void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplor
         }
     }
     else if ( currentNodeIdx == pathStart || !world.isTileBlocked( currentNodeIdx, fromWater ) ) {
-        checkAdjacentNodes( nodesToExplore, pathStart, currentNodeIdx, fromWater );
+        checkAdjacentNodes( pathStart, currentNodeIdx, fromWater );
     }
 }
 
@@ -289,9 +513,79 @@ void AIWorldPathfinder::reset()
     if ( _pathStart != -1 ) {
         _pathStart = -1;
         _currentColor = Color::NONE;
+        _changedTiles.clear();
         _armyStrength = -1;
         _pathfindingSkill = Skill::Level::EXPERT;
     }
+
+    _cachedMaps.clear();
+}
+
+void AIWorldPathfinder::markTileAsChanged( int index )
+{
+    WorldPathfinder::markTileAsChanged( index );
+
+    for ( auto it = _cachedMaps.begin(); it != _cachedMaps.end(); ) {
+        if ( it->changedTiles.size() >= maxChangedTiles ) {
+            it = _cachedMaps.erase( it );
+        }
+        else {
+            it->changedTiles.push_back( index );
+            ++it;
+        }
+    }
+}
+
+size_t AIWorldPathfinder::getCachedMapsSize() const
+{
+    size_t size = 0;
+    for ( const CachedMap & cachedMap : _cachedMaps ) {
+        size += cachedMap.nodes.capacity() * sizeof( PathfindingNode ) + cachedMap.changedTiles.capacity() * sizeof( int );
+    }
+    return size;
+}
+
+bool AIWorldPathfinder::restoreCachedMap( int start, int color, double armyStrength, uint8_t skill )
+{
+    // only results for the whole map can be reused
+    if ( _pathStart != -1 && _pathEnd == -1 ) {
+        CachedMap current;
+        current.start = _pathStart;
+        current.color = _currentColor;
+        current.armyStrength = _armyStrength;
+        current.skill = _pathfindingSkill;
+        current.nodes.swap( _cache );
+        current.changedTiles.swap( _changedTiles );
+
+        _cachedMaps.push_front( std::move( current ) );
+    }
+
+    bool isRestored = false;
+    for ( auto it = _cachedMaps.begin(); it != _cachedMaps.end(); ++it ) {
+        if ( it->start == start && it->color == color && std::fabs( it->armyStrength - armyStrength ) <= 0.001 && it->skill == skill ) {
+            _cache.swap( it->nodes );
+            _changedTiles.swap( it->changedTiles );
+            _cachedMaps.erase( it );
+            _pathEnd = -1;
+            isRestored = true;
+            break;
+        }
+    }
+
+    // drop the least recently used results, reuse the memory of one of them if needed
+    while ( !_cachedMaps.empty() && getCachedMapsSize() > _cachedMapsLimit ) {
+        if ( _cache.empty() )
+            _cache.swap( _cachedMaps.back().nodes );
+
+        _cachedMaps.pop_back();
+    }
+
+    if ( !isRestored ) {
+        _changedTiles.clear();
+        _cache.resize( world.getSize() );
+    }
+
+    return isRestored;
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
@@ -301,37 +595,46 @@ void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 
 void AIWorldPathfinder::reEvaluateIfNeeded( int start, int color, double armyStrength, uint8_t skill )
 {
-    if ( _pathStart != start || _currentColor != color || std::fabs( _armyStrength - armyStrength ) > 0.001 || _pathfindingSkill != skill ) {
+    if ( _pathStart != start || _currentColor != color || std::fabs( _armyStrength - armyStrength ) > 0.001 || _pathfindingSkill != skill || _pathEnd != -1 ) {
+        const bool isCached = restoreCachedMap( start, color, armyStrength, skill );
+
         _pathStart = start;
         _currentColor = color;
         _armyStrength = armyStrength;
         _pathfindingSkill = skill;
 
-        processWorldMap( start );
+        if ( !isCached )
+            processWorldMap( start );
+        else if ( !_changedTiles.empty() )
+            updateWorldMap();
+    }
+    else if ( !_changedTiles.empty() ) {
+        updateWorldMap();
     }
 }
 
 // Overwrites base version in WorldPathfinder, using custom node passability rules
-void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater )
+void AIWorldPathfinder::processCurrentNode( int pathStart, int currentNodeIdx, bool fromWater )
 {
     const bool isFirstNode = currentNodeIdx == pathStart;
     PathfindingNode & currentNode = _cache[currentNodeIdx];
 
     // find out if current node is protected by a strong army
     auto protectionCheck = [this]( const int index ) {
-        const Maps::Tiles & tile = world.GetTiles( index );
-        if ( MP2::isProtectedObject( tile.GetObject() ) ) {
-            _temporaryArmy.setFromTile( tile );
+        if ( MP2::isProtectedObject( world.getTileInfo( index ).object ) ) {
+            _temporaryArmy.setFromTile( world.GetTiles( index ) );
             return _temporaryArmy.GetStrength() * _advantage > _armyStrength;
         }
         return false;
     };
 
     bool isProtected = protectionCheck( currentNodeIdx );
-    if ( !isProtected ) {
-        const MapsIndexes & monsters = Maps::GetTilesUnderProtection( currentNodeIdx );
-        for ( auto it = monsters.begin(); it != monsters.end(); ++it ) {
-            if ( protectionCheck( *it ) ) {
+    const uint16_t protection = world.getTileProtection( currentNodeIdx );
+    if ( !isProtected && protection != 0 ) {
+        const Directions & directions = Direction::All();
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( ( protection & directions[i] ) && protectionCheck( currentNodeIdx + _mapOffset[i] ) ) {
                 isProtected = true;
                 break;
             }
@@ -348,7 +651,7 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, i
 
         // do not check adjacent if we're going through the teleport in the middle of the path
         if ( isFirstNode || teleporters.empty() || std::find( teleporters.begin(), teleporters.end(), currentNode._from ) != teleporters.end() ) {
-            checkAdjacentNodes( nodesToExplore, pathStart, currentNodeIdx, fromWater );
+            checkAdjacentNodes( pathStart, currentNodeIdx, fromWater );
         }
 
         // special case: move through teleporters
@@ -363,12 +666,22 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, i
                 teleportNode._from = currentNodeIdx;
                 teleportNode._cost = currentNode._cost;
                 teleportNode._objectID = MP2::OBJ_STONELITHS;
-                nodesToExplore.push_back( teleportIdx );
+                addNodeToExplore( teleportIdx );
             }
         }
     }
 }
 
+uint32_t AIWorldPathfinder::getGoalHeuristicLimit( int pathEnd ) const
+{
+    // teleports move the army for free, so the remaining cost can't be estimated lower than from the closest stonelith
+    uint32_t limit = UINT32_MAX;
+    for ( const int teleportIdx : world.getAllTeleporters() ) {
+        limit = std::min( limit, getMinimalMovementCost( teleportIdx, pathEnd ) );
+    }
+    return limit;
+}
+
 int AIWorldPathfinder::getFogDiscoveryTile( const Heroes & hero )
 {
     // paths have to be pre-calculated to find a spot where we're able to move
@@ -391,14 +704,13 @@ int AIWorldPathfinder::getFogDiscoveryTile( const Heroes & hero )
                 if ( newIndex == start )
                     continue;
 
-                if ( world.GetTiles( newIndex ).isFog( _currentColor ) ) {
+                if ( world.getTileInfo( newIndex ).isFog( _currentColor ) ) {
                     return currentNodeIdx;
                 }
                 else if ( !tilesVisited[newIndex] ) {
                     tilesVisited[newIndex] = true;
 
-                    const MapsIndexes & monsters = Maps::GetTilesUnderProtection( newIndex );
-                    if ( _cache[newIndex]._cost && monsters.empty() )
+                    if ( _cache[newIndex]._cost && world.getTileProtection( newIndex ) == 0 )
                         nodesToExplore.push_back( newIndex );
                 }
             }
@@ -508,6 +820,253 @@ uint32_t AIWorldPathfinder::getDistance( const Heroes & hero, int targetIndex )
 
 uint32_t AIWorldPathfinder::getDistance( int start, int targetIndex, int color, double armyStrength, uint8_t skill )
 {
-    reEvaluateIfNeeded( start, color, armyStrength, skill );
+    // a previous search is good enough if it covered the whole map or was done for the same target
+    if ( _pathStart != start || _currentColor != color || std::fabs( _armyStrength - armyStrength ) > 0.001 || _pathfindingSkill != skill ) {
+        const bool isCached = restoreCachedMap( start, color, armyStrength, skill );
+
+        _pathStart = start;
+        _currentColor = color;
+        _armyStrength = armyStrength;
+        _pathfindingSkill = skill;
+
+        if ( !isCached )
+            processWorldMap( start, targetIndex );
+        else if ( !_changedTiles.empty() )
+            updateWorldMap();
+    }
+    else if ( _pathEnd != -1 && _pathEnd != targetIndex ) {
+        processWorldMap( start, targetIndex );
+    }
+    else if ( !_changedTiles.empty() ) {
+        if ( _pathEnd == -1 )
+            updateWorldMap();
+        else
+            processWorldMap( start, targetIndex );
+    }
     return _cache[targetIndex]._cost;
 }
+
+void AIWorldPathfinder::getDistances( std::vector<ArmyDistanceRequest> & requests, int color, uint8_t skill )
+{
+    fheroes2::ThreadPool & threadPool = fheroes2::ThreadPool::Get();
+
+    // every thread needs its own pathfinder; their results are not kept between calls as they don't track map changes
+    while ( _workerPathfinders.size() < threadPool.workerCount() ) {
+        _workerPathfinders.emplace_back( new AIWorldPathfinder( _advantage, 0 ) );
+    }
+
+    for ( std::unique_ptr<AIWorldPathfinder> & pathfinder : _workerPathfinders ) {
+        pathfinder->reset();
+    }
+
+    threadPool.runTasks( requests.size(), [this, &requests, color, skill]( size_t taskId, size_t workerId ) {
+        AIWorldPathfinder & pathfinder = *_workerPathfinders[workerId];
+        ArmyDistanceRequest & request = requests[taskId];
+
+        // one search over the whole map gives distances to all targets at once
+        pathfinder.reEvaluateIfNeeded( request.start, color, request.armyStrength, skill );
+
+        request.distances.clear();
+        for ( const int targetIndex : request.targets ) {
+            request.distances.push_back( pathfinder.getDistance( targetIndex ) );
+        }
+    } );
+}
+
+void RegionGraph::clear()
+{
+    _nodes.clear();
+    _regionNodes.clear();
+}
+
+void RegionGraph::build( const std::vector<MapRegion> & regions )
+{
+    clear();
+
+    _regionNodes.resize( regions.size() );
+
+    const Directions & directions = Direction::All();
+
+    // Step 1. Borders are the tiles of a region next to another region of the same kind, one node per pair of regions
+    std::map<std::pair<uint32_t, uint32_t>, size_t> borderNodes;
+    for ( const MapRegion & region : regions ) {
+        if ( region._id < REGION_NODE_FOUND )
+            continue;
+
+        for ( const MapRegionNode & regionNode : region._nodes ) {
+            const int tileIndex = regionNode.index;
+
+            for ( const int direction : directions ) {
+                if ( !Maps::isValidDirection( tileIndex, direction ) )
+                    continue;
+
+                const uint32_t neighbour = world.GetTiles( Maps::GetDirectionIndex( tileIndex, direction ) ).GetRegion();
+                if ( neighbour < REGION_NODE_FOUND || neighbour >= regions.size() || neighbour == region._id || regions[neighbour]._isWater != region._isWater )
+                    continue;
+
+                const auto inserted = borderNodes.emplace( std::make_pair( region._id, neighbour ), _nodes.size() );
+                if ( inserted.second ) {
+                    _nodes.emplace_back();
+                    _nodes.back().region = region._id;
+                    _regionNodes[region._id].push_back( inserted.first->second );
+                }
+
+                std::vector<int> & tiles = _nodes[inserted.first->second].tiles;
+                if ( tiles.empty() || tiles.back() != tileIndex )
+                    tiles.push_back( tileIndex );
+            }
+        }
+    }
+
+    // crossing a border costs at least one step to the cheapest tile on the other side
+    for ( const auto & border : borderNodes ) {
+        const auto reverse = borderNodes.find( std::make_pair( border.first.second, border.first.first ) );
+        if ( reverse == borderNodes.end() )
+            continue;
+
+        uint32_t cost = UINT32_MAX;
+        for ( const int tileIndex : _nodes[reverse->second].tiles ) {
+            cost = std::min( cost, getMinimalStepPenalty( world.GetTiles( tileIndex ) ) );
+        }
+        _nodes[border.second].edges.emplace_back( reverse->second, cost );
+    }
+
+    // Step 2. Every stonelith is a node connected to its exits for free
+    const MapsIndexes & teleporters = world.getAllTeleporters();
+    const size_t firstTeleportNode = _nodes.size();
+    for ( const int teleportIdx : teleporters ) {
+        const uint32_t region = world.GetTiles( teleportIdx ).GetRegion();
+        if ( region < REGION_NODE_FOUND || region >= regions.size() )
+            continue;
+
+        _nodes.emplace_back();
+        _nodes.back().region = region;
+        _nodes.back().tiles.push_back( teleportIdx );
+        _regionNodes[region].push_back( _nodes.size() - 1 );
+    }
+
+    for ( size_t entrance = firstTeleportNode; entrance < _nodes.size(); ++entrance ) {
+        const Maps::Tiles & entranceTile = world.GetTiles( _nodes[entrance].tiles.front() );
+
+        for ( size_t exit = firstTeleportNode; exit < _nodes.size(); ++exit ) {
+            const Maps::Tiles & exitTile = world.GetTiles( _nodes[exit].tiles.front() );
+            if ( exit != entrance && exitTile.GetObjectSpriteIndex() == entranceTile.GetObjectSpriteIndex() && exitTile.isWater() == entranceTile.isWater() )
+                _nodes[entrance].edges.emplace_back( exit, 0 );
+        }
+    }
+
+    // Step 3. Connect the nodes of each region with the cheapest way between them inside of the region
+    std::vector<uint32_t> costs( world.getSize(), UINT32_MAX );
+    PathfindingQueue nodesToExplore( Maps::Ground::slowestMovePenalty * 3 / 2 );
+
+    for ( const MapRegion & region : regions ) {
+        const std::vector<size_t> & regionNodes = _regionNodes[region._id];
+        if ( region._id < REGION_NODE_FOUND || regionNodes.size() < 2 )
+            continue;
+
+        for ( const size_t nodeId : regionNodes ) {
+            for ( const MapRegionNode & regionNode : region._nodes )
+                costs[regionNode.index] = UINT32_MAX;
+
+            nodesToExplore.clear();
+            for ( const int tileIndex : _nodes[nodeId].tiles ) {
+                costs[tileIndex] = 0;
+                nodesToExplore.push( tileIndex, 0 );
+            }
+
+            while ( !nodesToExplore.empty() ) {
+                const int currentIdx = nodesToExplore.pop();
+                if ( nodesToExplore.currentPriority() != costs[currentIdx] )
+                    continue;
+
+                for ( const int direction : directions ) {
+                    if ( !Maps::isValidDirection( currentIdx, direction ) )
+                        continue;
+
+                    const int newIndex = Maps::GetDirectionIndex( currentIdx, direction );
+                    const Maps::Tiles & tile = world.GetTiles( newIndex );
+                    if ( tile.GetRegion() != region._id )
+                        continue;
+
+                    uint32_t penalty = getMinimalStepPenalty( tile );
+                    if ( Direction::isDiagonal( direction ) )
+                        penalty = penalty * 3 / 2;
+
+                    if ( costs[currentIdx] + penalty < costs[newIndex] ) {
+                        costs[newIndex] = costs[currentIdx] + penalty;
+                        nodesToExplore.push( newIndex, costs[newIndex] );
+                    }
+                }
+            }
+
+            for ( const size_t otherId : regionNodes ) {
+                if ( otherId == nodeId )
+                    continue;
+
+                uint32_t cost = UINT32_MAX;
+                for ( const int tileIndex : _nodes[otherId].tiles )
+                    cost = std::min( cost, costs[tileIndex] );
+
+                if ( cost != UINT32_MAX )
+                    _nodes[nodeId].edges.emplace_back( otherId, cost );
+            }
+        }
+    }
+
+    DEBUG_LOG( DBG_AI, DBG_TRACE, "region graph has " << _nodes.size() << " nodes for " << regions.size() << " regions" );
+}
+
+uint32_t RegionGraph::getDistanceEstimate( int from, int to ) const
+{
+    const Maps::Tiles & fromTile = world.GetTiles( from );
+    const Maps::Tiles & toTile = world.GetTiles( to );
+    const uint32_t fromRegion = fromTile.GetRegion();
+    const uint32_t toRegion = toTile.GetRegion();
+
+    // the graph only covers movement between passable tiles of the same kind
+    if ( fromRegion < REGION_NODE_FOUND || toRegion < REGION_NODE_FOUND || fromRegion >= _regionNodes.size() || toRegion >= _regionNodes.size()
+         || fromTile.isWater() != toTile.isWater() )
+        return getMinimalMovementCostWithTeleports( from, to );
+
+    // any way that doesn't leave the region or use a stonelith can't be cheaper than a straight line
+    uint32_t result = ( fromRegion == toRegion ) ? getMinimalMovementCost( from, to ) : UINT32_MAX;
+
+    typedef std::pair<uint32_t, size_t> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > nodesToExplore;
+    std::vector<uint32_t> costs( _nodes.size(), UINT32_MAX );
+
+    for ( const size_t nodeId : _regionNodes[fromRegion] ) {
+        for ( const int tileIndex : _nodes[nodeId].tiles )
+            costs[nodeId] = std::min( costs[nodeId], getMinimalMovementCost( from, tileIndex ) );
+
+        nodesToExplore.emplace( costs[nodeId], nodeId );
+    }
+
+    while ( !nodesToExplore.empty() ) {
+        const QueueEntry current = nodesToExplore.top();
+        nodesToExplore.pop();
+
+        if ( current.first != costs[current.second] )
+            continue;
+
+        // the rest of the nodes can't lead to a cheaper result
+        if ( current.first >= result )
+            break;
+
+        const Node & node = _nodes[current.second];
+        if ( node.region == toRegion ) {
+            for ( const int tileIndex : node.tiles )
+                result = std::min( result, current.first + getMinimalMovementCost( tileIndex, to ) );
+        }
+
+        for ( const std::pair<size_t, uint32_t> & edge : node.edges ) {
+            const uint32_t cost = current.first + edge.second;
+            if ( cost < costs[edge.first] ) {
+                costs[edge.first] = cost;
+                nodesToExplore.emplace( cost, edge.first );
+            }
+        }
+    }
+
+    return result;
+}
@@ -20,17 +20,20 @@
 
 #pragma once
 
+#include <memory>
+
 #include "army.h"
 #include "color.h"
 #include "pairs.h"
 #include "pathfinding.h"
 #include "route.h"
+#include "world_regions.h"
 
 // Abstract class that provides base functionality to path through World map
 class WorldPathfinder : public Pathfinder<PathfindingNode>
 {
 public:
-    WorldPathfinder() {}
+    WorldPathfinder();
 
     // This method resizes the cache and re-calculates map offsets if values are out of sync with World class
     virtual void checkWorldSize();
@@ -39,16 +42,40 @@ public:
     bool isBlockedByObject( int target, bool fromWater = false ) const;
     uint32_t getMovementPenalty( int start, int target, int direction, uint8_t skill = Skill::Level::EXPERT ) const;
 
+    // Remembers that the tile content has changed; only the affected part of the map is re-evaluated on the next request
+    virtual void markTileAsChanged( int index );
+
+    // Number of map searches (full or partial) done by all pathfinders since the start of the program
+    static uint64_t getSearchCount();
+
 protected:
-    void processWorldMap( int pathStart );
-    void checkAdjacentNodes( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater );
+    // Nodes are explored in the order of their movement cost. If pathEnd is set the search is goal-directed (A*)
+    // and stops as soon as pathEnd is reached, so only nodes on the way to it have their final cost.
+    void processWorldMap( int pathStart, int pathEnd = -1 );
+    // Repairs the result of the last full search after tiles have changed: nodes whose path goes through or next to
+    // a changed tile are reset and reached again from the rest of the map
+    void updateWorldMap();
+    void processQueue( int pathStart, int pathEnd, bool fromWater );
+    void checkAdjacentNodes( int pathStart, int currentNodeIdx, bool fromWater );
+    void addNodeToExplore( int index );
+    uint32_t getGoalHeuristic( int index ) const;
+
+    // Upper bound for the goal heuristic; derived classes that allow to skip tiles (teleports) must lower it to keep A* exact
+    virtual uint32_t getGoalHeuristicLimit( int pathEnd ) const;
 
     // This method defines pathfinding rules. This has to be implemented by the derived class.
-    virtual void processCurrentNode( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater ) = 0;
+    virtual void processCurrentNode( int pathStart, int currentNodeIdx, bool fromWater ) = 0;
 
     uint8_t _pathfindingSkill = Skill::Level::EXPERT;
     int _currentColor = Color::NONE;
+    int _pathEnd = -1;
+    uint32_t _goalHeuristicLimit = 0;
     std::vector<int> _mapOffset;
+    PathfindingQueue _nodesToExplore;
+    std::vector<int> _changedTiles;
+    std::vector<uint8_t> _nodeState;
+
+    static const size_t maxChangedTiles = 64;
 };
 
 class PlayerWorldPathfinder : public WorldPathfinder
@@ -61,14 +88,30 @@ public:
     std::list<Route::Step> buildPath( int targetIndex ) const;
 
 private:
-    void processCurrentNode( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater ) override;
+    void processCurrentNode( int pathStart, int currentNodeIdx, bool fromWater ) override;
+};
+
+// Distance request for an army which isn't led by a hero, like a castle garrison
+struct ArmyDistanceRequest
+{
+    ArmyDistanceRequest( int start_, double armyStrength_ )
+        : start( start_ )
+        , armyStrength( armyStrength_ )
+    {}
+
+    int start;
+    double armyStrength;
+    std::vector<int> targets;
+    std::vector<uint32_t> distances; // filled by AIWorldPathfinder::getDistances in the same order as targets
 };
 
 class AIWorldPathfinder : public WorldPathfinder
 {
 public:
-    AIWorldPathfinder( double advantage )
+    // Results for other armies are kept while they fit into cachedMapsLimit bytes
+    explicit AIWorldPathfinder( double advantage, size_t cachedMapsLimit = defaultCachedMapsLimit )
         : _advantage( advantage )
+        , _cachedMapsLimit( cachedMapsLimit )
     {}
     virtual void reset() override;
 
@@ -78,19 +121,78 @@ public:
     std::vector<IndexObject> getObjectsOnTheWay( int targetIndex, bool checkAdjacent = false );
     uint32_t getDistance( const Heroes & hero, int targetIndex );
 
-    // Used for non-hero armies, like castles or monsters
+    // Used for non-hero armies, like castles or monsters. Search stops once the target is reached.
     uint32_t getDistance( int start, int targetIndex, int color, double armyStrength, uint8_t skill = Skill::Level::EXPERT );
 
+    // Same as above for many armies at once: one whole map search per request gives distances to all its targets.
+    // Requests are processed in parallel by the shared thread pool.
+    void getDistances( std::vector<ArmyDistanceRequest> & requests, int color, uint8_t skill = Skill::Level::EXPERT );
+
     // Override builds path to the nearest valid object
     std::list<Route::Step> buildPath( int targetIndex, bool isPlanningMode = false ) const;
 
     // Faster, but does not re-evaluate the map (expose base class method)
     using Pathfinder::getDistance;
 
+    virtual void markTileAsChanged( int index ) override;
+
+    // Memory used by the results kept for other armies
+    size_t getCachedMapsSize() const;
+
 private:
-    void processCurrentNode( std::vector<int> & nodesToExplore, int pathStart, int currentNodeIdx, bool fromWater ) override;
+    // Result of a whole map search for one army, kept to be reused when the AI switches between heroes
+    struct CachedMap
+    {
+        int start;
+        int color;
+        double armyStrength;
+        uint8_t skill;
+        std::vector<PathfindingNode> nodes;
+        std::vector<int> changedTiles;
+    };
+
+    void processCurrentNode( int pathStart, int currentNodeIdx, bool fromWater ) override;
+    uint32_t getGoalHeuristicLimit( int pathEnd ) const override;
+
+    // Moves the current result into the cache and takes the one for the given army out of it. Returns false if there is none.
+    bool restoreCachedMap( int start, int color, double armyStrength, uint8_t skill );
 
     double _armyStrength = -1;
     double _advantage = 1.0;
     Army _temporaryArmy; // for internal calculations
+    std::list<CachedMap> _cachedMaps; // most recently used first
+    size_t _cachedMapsLimit;
+    std::vector<std::unique_ptr<AIWorldPathfinder> > _workerPathfinders;
+
+    static const size_t defaultCachedMapsLimit = 16 * 1024 * 1024;
+};
+
+// Abstract graph built on top of map regions (see World::ComputeStaticAnalysis). Nodes are region borders and stoneliths,
+// edges hold the lowest movement cost between them. It allows to estimate long distances by visiting a few hundred nodes
+// instead of every tile; the exact cost is still found by the tile level pathfinders.
+class RegionGraph
+{
+public:
+    void build( const std::vector<MapRegion> & regions );
+    void clear();
+
+    // Lower bound of the movement cost between two tiles: terrain is crossed with expert pathfinding and objects never block the way.
+    // Returns UINT32_MAX if the tiles aren't connected at all.
+    uint32_t getDistanceEstimate( int from, int to ) const;
+
+    size_t getNodeCount() const
+    {
+        return _nodes.size();
+    }
+
+private:
+    struct Node
+    {
+        uint32_t region = 0;
+        std::vector<int> tiles;
+        std::vector<std::pair<size_t, uint32_t> > edges; // target node and cost
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<std::vector<size_t> > _regionNodes;
 };
@@ -196,6 +196,11 @@ const MapRegion & World::getRegion( size_t id ) const
     return region;
 }
 
+const RegionGraph & World::getRegionGraph() const
+{
+    return _regionGraph;
+}
+
 void World::ComputeStaticAnalysis()
 {
     // Parameters that control region generation: size and spacing between initial points
@@ -386,4 +391,7 @@ void World::ComputeStaticAnalysis()
             }
         }
     }
+
+    // Step 10. Build the graph of regions used for long distance estimates
+    _regionGraph.build( _regions );
 }
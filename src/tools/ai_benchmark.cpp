@@ -0,0 +1,208 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+// Headless AI versus AI game used to measure the speed of AI turns. It's linked with all game sources except fheroes2.cpp.
+// Usage: fheroes2-ai-benchmark <map file> [number of days]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "agg.h"
+#include "ai.h"
+#include "battle.h"
+#include "bin_info.h"
+#include "engine.h"
+#include "game.h"
+#include "game_interface.h"
+#include "game_over.h"
+#include "logging.h"
+#include "maps_fileinfo.h"
+#include "screen.h"
+#include "settings.h"
+#include "system.h"
+#include "tools.h"
+#include "world.h"
+#include "world_pathfinding.h"
+
+namespace
+{
+    void readConfig( Settings & conf )
+    {
+        const ListFiles & files = Settings::GetListFiles( "", "fheroes2.cfg" );
+
+        for ( ListFiles::const_iterator it = files.begin(); it != files.end(); ++it ) {
+            if ( System::IsFile( *it ) && conf.Read( *it ) )
+                return;
+        }
+    }
+
+    bool loadMap( Settings & conf, const std::string & mapFile )
+    {
+        Maps::FileInfo fileInfo;
+        const std::string lower = StringLower( mapFile );
+        const bool isMP2 = lower.size() > 3 && ( lower.substr( lower.size() - 3 ) == "mp2" || lower.substr( lower.size() - 3 ) == "mx2" );
+
+        if ( !isMP2 || !fileInfo.ReadMP2( mapFile ) ) {
+            ERROR_LOG( mapFile << " is not a valid MP2 map" );
+            return false;
+        }
+
+        conf.SetCurrentFileInfo( fileInfo );
+        conf.SetGameType( Game::TYPE_STANDARD );
+
+        Players & players = conf.GetPlayers();
+        for ( Player * player : players ) {
+            player->SetControl( CONTROL_AI );
+        }
+        players.SetStartGame();
+
+        if ( !world.LoadMapMP2( mapFile ) ) {
+            ERROR_LOG( "failed to load " << mapFile );
+            return false;
+        }
+
+        AI::Get().Reset();
+        GameOver::Result::Get().Reset();
+        Interface::Basic::Get().Reset();
+
+        // a new game starts from day 1 like in Interface::Basic::StartGame
+        world.NewDay();
+
+        return true;
+    }
+
+    int countPlayingKingdoms( const Players & players )
+    {
+        return static_cast<int>( std::count_if( players.begin(), players.end(), []( const Player * player ) { return world.GetKingdom( player->GetColor() ).isPlay(); } ) );
+    }
+
+    // Plays the given number of days and prints one line per kingdom turn. Returns false if the game has ended before.
+    bool runDays( Settings & conf, const int days )
+    {
+        const Players & players = conf.GetPlayers();
+        // kingdoms take turns in the same order as in the game loop
+        const std::vector<Player *> sortedPlayers = players.getInTurnOrder();
+
+        double totalTime = 0;
+        double maxTime = 0;
+        int turnCount = 0;
+        const uint64_t startSearches = WorldPathfinder::getSearchCount();
+        const uint32_t startBattles = Battle::GetBattleCount();
+
+        COUT( "day,color,time_ms,pathfinder_searches,battles" );
+
+        for ( int day = 0; day < days; ++day ) {
+            if ( countPlayingKingdoms( players ) < 2 ) {
+                COUT( "game is over on " << world.DateString() );
+                break;
+            }
+
+            for ( const Player * player : sortedPlayers ) {
+                Kingdom & kingdom = world.GetKingdom( player->GetColor() );
+                if ( !kingdom.isPlay() )
+                    continue;
+
+                const uint64_t searches = WorldPathfinder::getSearchCount();
+                const uint32_t battles = Battle::GetBattleCount();
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                conf.SetCurrentColor( player->GetColor() );
+                world.ClearFog( player->GetColor() );
+                kingdom.ActionBeforeTurn();
+                AI::Get().KingdomTurn( kingdom );
+
+                const double time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+                totalTime += time;
+                maxTime = std::max( maxTime, time );
+                ++turnCount;
+
+                COUT( world.CountDay() << "," << Color::String( player->GetColor() ) << "," << time << "," << WorldPathfinder::getSearchCount() - searches << ","
+                                       << Battle::GetBattleCount() - battles );
+            }
+
+            world.NewDay();
+        }
+
+        COUT( "turns: " << turnCount << ", total time: " << totalTime << " ms, average turn: " << ( turnCount > 0 ? totalTime / turnCount : 0 )
+                        << " ms, longest turn: " << maxTime << " ms" );
+        COUT( "pathfinder searches: " << WorldPathfinder::getSearchCount() - startSearches << ", battles: " << Battle::GetBattleCount() - startBattles );
+
+        return turnCount > 0;
+    }
+}
+
+#if defined( _MSC_VER )
+#undef main
+#endif
+
+int main( int argc, char ** argv )
+{
+    if ( argc < 2 ) {
+        COUT( "Usage: " << argv[0] << " <map file> [number of days, 28 by default]" );
+        return EXIT_SUCCESS;
+    }
+
+    const std::string mapFile = argv[1];
+    const int days = argc > 2 ? GetInt( argv[2] ) : 28;
+
+    Logging::InitLog();
+
+    Settings & conf = Settings::Get();
+    conf.SetProgramPath( argv[0] );
+    readConfig( conf );
+
+    // Nothing is shown or played: the AI turn is measured without the time spent on rendering and audio
+    conf.SetHeadless( true );
+    conf.ResetSound();
+    conf.ResetMusic();
+    System::SetEnvironment( "SDL_VIDEODRIVER", "dummy" );
+    System::SetEnvironment( "SDL_AUDIODRIVER", "dummy" );
+
+    if ( !SDL::Init( INIT_VIDEO ) )
+        return EXIT_FAILURE;
+
+    std::atexit( SDL::Quit );
+
+    int result = EXIT_FAILURE;
+
+    try {
+        fheroes2::Display::instance().resize( conf.VideoMode().width, conf.VideoMode().height );
+
+        if ( AGG::Init() ) {
+            Bin_Info::InitBinInfo();
+            Game::Init();
+
+            if ( loadMap( conf, mapFile ) && runDays( conf, days ) )
+                result = EXIT_SUCCESS;
+
+            AGG::Quit();
+        }
+    }
+    catch ( const std::exception & ex ) {
+        ERROR_LOG( "Exception '" << ex.what() << "' occured during benchmark." );
+    }
+
+    fheroes2::Display::instance().release();
+
+    return result;
+}
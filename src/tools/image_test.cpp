@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+// Checks that every vectorized code path of Blit and AlphaBlit draws exactly the same pixels as the scalar one. Random sprites are
+// drawn flipped and not, partially outside of the output image. It needs only the engine. Returns non-zero exit code on the first mismatch.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "image.h"
+#include "logging.h"
+
+namespace
+{
+    const int testCount = 2000;
+
+    // Transform layer is filled by runs of the same value of random length, longer than a vector register too,
+    // as run length kernels look exactly for them. Most of the runs are opaque (0) or skipped (1), the rest are shadows.
+    fheroes2::Sprite createSprite( std::mt19937 & generator )
+    {
+        std::uniform_int_distribution<int32_t> sizeDistribution( 1, 100 );
+        fheroes2::Sprite sprite( sizeDistribution( generator ), sizeDistribution( generator ) );
+
+        std::uniform_int_distribution<int> byteDistribution( 0, 255 );
+        const size_t size = static_cast<size_t>( sprite.width() ) * static_cast<size_t>( sprite.height() );
+        uint8_t * image = sprite.image();
+        for ( size_t i = 0; i < size; ++i ) {
+            image[i] = static_cast<uint8_t>( byteDistribution( generator ) );
+        }
+
+        std::uniform_int_distribution<int> transformDistribution( 0, 9 );
+        std::uniform_int_distribution<int> shadowDistribution( 2, 15 );
+        std::uniform_int_distribution<size_t> runDistribution( 1, 70 );
+        uint8_t * transform = sprite.transform();
+        for ( size_t i = 0; i < size; ) {
+            const int type = transformDistribution( generator );
+            const uint8_t value = static_cast<uint8_t>( type < 4 ? 0 : ( type < 8 ? 1 : shadowDistribution( generator ) ) );
+            const size_t length = std::min( runDistribution( generator ), size - i );
+            std::memset( transform + i, value, length );
+            i += length;
+        }
+
+        return sprite;
+    }
+
+    bool isEqual( const fheroes2::Image & first, const fheroes2::Image & second )
+    {
+        const size_t size = static_cast<size_t>( first.width() ) * static_cast<size_t>( first.height() );
+        return std::memcmp( first.image(), second.image(), size ) == 0 && std::memcmp( first.transform(), second.transform(), size ) == 0;
+    }
+
+    bool checkCodePath( const fheroes2::BlitCodePath path, const char * name )
+    {
+        if ( !fheroes2::SetBlitCodePath( path ) ) {
+            COUT( name << ": not supported" );
+            return true;
+        }
+
+        // the same sequence of sprites and positions for every code path
+        std::mt19937 generator( 1 );
+
+        std::uniform_int_distribution<int32_t> positionDistribution( -40, 140 );
+        std::uniform_int_distribution<int32_t> sizeDistribution( 0, 110 );
+        std::uniform_int_distribution<int> alphaDistribution( 0, 255 );
+
+        for ( int testId = 0; testId < testCount; ++testId ) {
+            const fheroes2::Sprite in = createSprite( generator );
+
+            fheroes2::Image background( 128, 128 );
+            background.fill( static_cast<uint8_t>( testId ) );
+
+            // input area starts within the sprite, output area can go over any edge of the output image
+            const int32_t inX = std::uniform_int_distribution<int32_t>( 0, in.width() - 1 )( generator );
+            const int32_t inY = std::uniform_int_distribution<int32_t>( 0, in.height() - 1 )( generator );
+            const int32_t outX = positionDistribution( generator );
+            const int32_t outY = positionDistribution( generator );
+            const int32_t width = sizeDistribution( generator );
+            const int32_t height = sizeDistribution( generator );
+            const bool flip = ( testId % 2 ) == 1;
+            const uint8_t alpha = static_cast<uint8_t>( alphaDistribution( generator ) );
+
+            fheroes2::Image expected[2] = { background, background };
+            fheroes2::Image result[2] = { background, background };
+
+            fheroes2::SetBlitCodePath( fheroes2::BlitCodePath::SCALAR );
+            fheroes2::Blit( in, inX, inY, expected[0], outX, outY, width, height, flip );
+            fheroes2::AlphaBlit( in, inX, inY, expected[1], outX, outY, width, height, alpha, flip );
+
+            fheroes2::SetBlitCodePath( path );
+            fheroes2::Blit( in, inX, inY, result[0], outX, outY, width, height, flip );
+            fheroes2::AlphaBlit( in, inX, inY, result[1], outX, outY, width, height, alpha, flip );
+
+            for ( int i = 0; i < 2; ++i ) {
+                if ( !isEqual( expected[i], result[i] ) ) {
+                    ERROR_LOG( name << ": " << ( i == 0 ? "Blit" : "AlphaBlit" ) << " differs from the scalar code in test " << testId << ", sprite "
+                                    << in.width() << "x" << in.height() << ", area " << inX << ", " << inY << ", " << width << "x" << height << " to "
+                                    << outX << ", " << outY << ( flip ? ", flipped" : "" ) );
+                    return false;
+                }
+            }
+        }
+
+        COUT( name << ": OK" );
+        return true;
+    }
+}
+
+#if defined( _MSC_VER )
+#undef main
+#endif
+
+int main( int, char ** )
+{
+    Logging::InitLog();
+
+    const bool sse2Result = checkCodePath( fheroes2::BlitCodePath::SSE2, "SSE2" );
+    const bool avx2Result = checkCodePath( fheroes2::BlitCodePath::AVX2, "AVX2" );
+    const bool neonResult = checkCodePath( fheroes2::BlitCodePath::NEON, "NEON" );
+
+    return sse2Result && avx2Result && neonResult ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+// Checks that the incremental repair of PlayerWorldPathfinder gives the same result as a full search. It's linked with all game
+// sources except fheroes2.cpp and does not need game data. Returns non-zero exit code on the first mismatch.
+
+#include <cstdlib>
+
+#include "color.h"
+#include "heroes.h"
+#include "logging.h"
+#include "maps.h"
+#include "mp2.h"
+#include "race.h"
+#include "rand.h"
+#include "world.h"
+#include "world_pathfinding.h"
+
+namespace
+{
+    const int32_t mapSize = 16;
+
+    // GROUND32.TIL sprites: 0 - 29 are water, 30 - 91 are grass
+    const uint32_t waterSprite = 16;
+    const uint32_t grassSprite = 30;
+
+    bool isCoast( const int32_t index )
+    {
+        const bool isWater = world.GetTiles( index ).isWater();
+
+        for ( const int direction : Direction::All() ) {
+            if ( Maps::isValidDirection( index, direction ) && world.GetTiles( Maps::GetDirectionIndex( index, direction ) ).isWater() != isWater )
+                return true;
+        }
+        return false;
+    }
+
+    // Land on the left and on the right of the map is divided by a lake in the middle
+    void createMap()
+    {
+        world.NewMaps( mapSize, mapSize );
+
+        for ( int32_t index = 0; index < mapSize * mapSize; ++index ) {
+            const int32_t x = index % mapSize;
+
+            Maps::Tiles & tile = world.GetTiles( index );
+            tile.SetTile( ( x >= 5 && x <= 10 ) ? waterSprite : grassSprite, 0 );
+            tile.ClearFog( Color::ALL );
+        }
+
+        for ( int32_t index = 0; index < mapSize * mapSize; ++index ) {
+            Maps::Tiles & tile = world.GetTiles( index );
+            tile.SetObject( ( !tile.isWater() && isCoast( index ) ) ? MP2::OBJ_COAST : MP2::OBJ_ZERO );
+        }
+    }
+
+    // Changes a random tile next to the shore except the hero's one: blocks or frees it, or turns land into water and back
+    int32_t changeCoastTile( const int32_t heroIndex )
+    {
+        int32_t index = -1;
+        do {
+            index = static_cast<int32_t>( Rand::Get( 0, mapSize * mapSize - 1 ) );
+        } while ( index == heroIndex || !isCoast( index ) );
+
+        Maps::Tiles & tile = world.GetTiles( index );
+        const int object = tile.GetObject( false );
+
+        switch ( Rand::Get( 0, 2 ) ) {
+        case 0:
+            tile.SetObject( object == MP2::OBJ_RESOURCE ? MP2::OBJ_ZERO : MP2::OBJ_RESOURCE );
+            break;
+        case 1:
+            tile.SetObject( object == MP2::OBJ_BOAT ? MP2::OBJ_ZERO : MP2::OBJ_BOAT );
+            break;
+        default:
+            tile.SetTile( tile.isWater() ? grassSprite : waterSprite, 0 );
+            tile.SetObject( tile.isWater() ? MP2::OBJ_ZERO : MP2::OBJ_COAST );
+            break;
+        }
+
+        return index;
+    }
+
+    bool checkHero( const int32_t startIndex, const char * name )
+    {
+        createMap();
+
+        Heroes hero( Heroes::LORDKILBURN, Race::KNGT );
+        hero.SetColor( Color::BLUE );
+        hero.SetIndex( startIndex );
+
+        // like on map load, the cache has to match the size of the map
+        PlayerWorldPathfinder repaired;
+        repaired.reset();
+        repaired.reEvaluateIfNeeded( hero );
+
+        for ( int step = 0; step < 500; ++step ) {
+            const int32_t changedIndex = changeCoastTile( startIndex );
+            repaired.markTileAsChanged( changedIndex );
+            repaired.reEvaluateIfNeeded( hero );
+
+            PlayerWorldPathfinder full;
+            full.reset();
+            full.reEvaluateIfNeeded( hero );
+
+            for ( int32_t index = 0; index < mapSize * mapSize; ++index ) {
+                if ( repaired.getDistance( index ) != full.getDistance( index ) ) {
+                    ERROR_LOG( name << ": step " << step << ", changed tile " << changedIndex << ", tile " << index << " has distance "
+                                    << repaired.getDistance( index ) << " instead of " << full.getDistance( index ) );
+                    return false;
+                }
+            }
+        }
+
+        COUT( name << ": OK" );
+        return true;
+    }
+}
+
+#if defined( _MSC_VER )
+#undef main
+#endif
+
+int main( int, char ** )
+{
+    Logging::InitLog();
+
+    const bool landResult = checkHero( 2 * mapSize + 2, "land hero" );
+    const bool boatResult = checkHero( 2 * mapSize + 7, "boat hero" );
+
+    return landResult && boatResult ? EXIT_SUCCESS : EXIT_FAILURE;
+}